@@ -0,0 +1,1002 @@
+// bench/supernova_bench.cpp
+// Benchmarks headless du coeur de simulation : pas de fenêtre, pas de GPU.
+//
+//   supernova_bench [--suite particles|gravity|snapshot|pipeline|packing|depth|splat|emitter]
+//                   [--sizes 10000,100000,1000000,10000000] [--steps 120] [--threads 0] [--seed N]
+//                   [--barnes-hut] [--sph] [--out supernova_bench.snap] [--profile PREFIX]
+//                   [--config FILE]
+//
+// particles suite (default): each size runs two fixed-step scenarios
+//   burst   all particles are spawned in the first measured step, then decay
+//   steady  the pool starts full and is topped up to capacity before every step
+// and reports the cost per particle per step, heap allocations per frame, peak
+// RSS and a checksum of the final state (same seed => same checksum at any
+// thread count). Exits with status 1 if any step allocated on the heap, if
+// a ThreadPool resized between parallel loops runs an item twice or not at all,
+// or if integrateParticles() and integrateParticlesScalar() disagree on a bit
+// for any mix of center pull and acceleration field.
+// --barnes-hut runs the scenarios with octree self-gravity instead of the
+// center pull; --sph adds SPH pressure and viscosity between particles. Both
+// also apply to the evolved shell the other suites start from.
+// In a -DSUPERNOVA_ENABLE_PROFILER=ON build every step closes a profiler frame
+// (allocations made by the profiler itself are not counted), the phase summary
+// is printed at the end and --profile writes PREFIX.json and PREFIX.csv. Use a
+// single --sizes value to keep the frames comparable. Run the particles and
+// pipeline suites in such a build with --threads 4 or more too: profiler rings
+// must be allocated before the first measured step, not by it.
+//
+// gravity suite: builds the Barnes-Hut tree over an evolved shell and reports
+// build and walk cost per particle for several opening angles, plus the
+// relative error against a direct O(n^2) sum on a sample of particles. Exits
+// with status 1 if the largest sampled error exceeds the bound of its angle
+// (0.05, 0.15, 0.4 and 0.75 for theta 0.3, 0.5, 0.7 and 1.0).
+//
+// snapshot suite: records `steps` frames of a steady run to --out in each
+// encoding and reports the time the simulation thread spends in submit(),
+// how often it waited for the disk, the file size, the cost of replaying every
+// frame from the mapping and the largest position error after decoding.
+// The file is deleted afterwards. Exits with status 1 if a frame is missing,
+// a raw frame differs or a quantized position is off by more than one 16-bit
+// step.
+//
+// pipeline suite: runs `steps` snapshot intervals of a steady run twice, once
+// stepping and drawing on one thread, once with a SimulationThread stepping
+// off-line while this thread keeps interpolating frames, and reports the wall
+// time per interval, the frames the consumer drew, allocations after start()
+// and whether both runs end on the same checksum. Exits with status 1 if they
+// do not, or if anything allocated while the simulation thread ran.
+//
+// packing suite: converts an evolved frame into GPU instances (the CPU half of
+// ParticleRenderer) on one thread and across the pool, and reports ns/particle
+// and the instance bandwidth. No GL context is needed. Before timing, an odd
+// range starting at 1 is packed by packInstances and packInstancesScalar; the
+// suite exits with status 1 unless both write the same bytes.
+//
+// depth suite: orbits the camera like the viewer (10 degrees per second at
+// 60 fps) for `steps` frames over a steady run, live and paused (one frozen
+// frame, as when a replay is paused), and sorts every frame back to front.
+// Reports ms per sort, the cost of packing in sorted order and whether every
+// order was a correctly sorted permutation; exits with status 1 if one was not.
+//
+// splat suite: renders `steps` frames of a steady run at 3840x2160 with the
+// CPU SplatRenderer, orbiting the camera like the depth suite, and reports ms
+// per frame, billboards on screen, tile entries per frame and whether the last
+// frame is identical when rendered on a single thread; exits with status 1 if
+// it is not. Frames take up to a second each on one core, so pass a small
+// --steps.
+//
+// emitter suite: generates `steps` batches of each size with the SIMD and the
+// scalar spawn kernels on one thread, reports ns/particle for both, whether
+// they wrote the same bits, and the latency of a burst of that size through
+// ParticleSystem::spawnParticles() across the pool (pages touched for the
+// first time included). Then it steps every supernova of --config (by default
+// four variants of the remnant, 100000 particles each) side by side for
+// `steps` steps, one instance per thread, and checks that each ends in the
+// same state as when it runs alone.
+#include "particle_system.h"
+#include "particle_kernels.h"
+#include "random.h"
+#include "barnes_hut.h"
+#include "snapshot.h"
+#include "simulation_thread.h"
+#include "particle_instances.h"
+#include "thread_pool.h"
+#include "depth_sort.h"
+#include "splat_renderer.h"
+#include "profiler.h"
+#include "emitter_config.h"
+#include "spawn_kernels.h"
+#include "../external/glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// --- Comptage des allocations (remplace l'opérateur new global) ---
+static std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t a = static_cast<std::size_t>(align);
+#if defined(_WIN32)
+    void* p = _aligned_malloc(size ? size : 1, a);
+#else
+    void* p = std::aligned_alloc(a, (size + a - 1) / a * a);
+#endif
+    if (p) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#if defined(_WIN32)
+void operator delete(void* p, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { _aligned_free(p); }
+#else
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+
+// --- Mémoire résidente maximale du processus ---
+static double peakRssMiB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+    return double(pmc.PeakWorkingSetSize) / (1024.0 * 1024.0);
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return double(usage.ru_maxrss) / (1024.0 * 1024.0); // bytes
+#else
+    return double(usage.ru_maxrss) / 1024.0;            // KiB
+#endif
+#endif
+}
+
+// FNV-1a over the live part of every stream
+static uint64_t checksum(const ParticleStore& s) {
+    uint64_t h = 1469598103934665603ull;
+    const AlignedBuffer<float>* streams[] = {&s.x, &s.y, &s.z, &s.vx, &s.vy, &s.vz,
+                                             &s.r, &s.g, &s.b, &s.life, &s.density};
+    for (const AlignedBuffer<float>* stream : streams) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(stream->data());
+        for (std::size_t i = 0; i < s.size() * sizeof(float); ++i) {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+    }
+    return h ^ s.size();
+}
+
+struct BenchOptions {
+    std::string suite = "particles";
+    std::vector<std::size_t> sizes;
+    unsigned int steps = 120;
+    unsigned int threads = 0;
+    uint64_t seed = ParticleSystem::defaultSeed;
+    bool barnesHut = false;
+    bool sph = false;
+    std::string out = "supernova_bench.snap";
+    std::string profile;
+    std::string config;
+};
+
+struct BenchResult {
+    double nsPerParticleStep;
+    double allocsPerFrame;
+    double peakRss;
+    uint64_t hash;
+};
+
+// Résultats des boucles mesurées : écrits par les suites et lus à la sortie,
+// pour que le compilateur ne puisse pas éliminer ces boucles
+static volatile double sink = 0.0;
+
+static void readSink() {
+    const double value = sink;
+    (void)value;
+}
+
+// Gravité et SPH demandés par --barnes-hut et --sph
+static void applyPhysics(ParticleSystem& ps, const BenchOptions& opt) {
+    if (opt.barnesHut) {
+        GravitySettings gravity;
+        gravity.mode = GravityMode::BarnesHut;
+        ps.setGravity(gravity);
+    }
+    if (opt.sph) {
+        SphSettings sph;
+        sph.enabled = true;
+        ps.setSph(sph);
+    }
+}
+
+// Fixture commune des suites : `particles` particules lâchées d'un coup, puis
+// `steps` pas de 1/60 s avec la physique et la graine des options
+static std::unique_ptr<ParticleSystem> evolvedSystem(std::size_t particles, int steps, const BenchOptions& opt) {
+    auto ps = std::make_unique<ParticleSystem>(unsigned(particles), opt.threads, opt.seed);
+    applyPhysics(*ps, opt);
+    ps->spawnParticles(unsigned(particles));
+    for (int step = 0; step < steps; ++step) ps->update(1.0f / 60.0f);
+    return ps;
+}
+
+static BenchResult runScenario(std::size_t size, bool steady, const BenchOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = 1.0f / 60.0f;
+
+    ParticleSystem ps(unsigned(size), opt.threads, opt.seed);
+    applyPhysics(ps, opt);
+    if (steady) ps.spawnParticles(unsigned(size)); // remplissage initial, hors mesure
+    SUPERNOVA_PROFILE_FRAME();                      // la préparation forme sa propre frame
+
+    uint64_t particleSteps = 0;
+    uint64_t profilerAllocs = 0;
+    uint64_t allocsBefore = allocationCount.load();
+    Clock::time_point start = Clock::now();
+    for (unsigned int step = 0; step < opt.steps; ++step) {
+        if (steady || step == 0) ps.spawnParticles(unsigned(size - ps.store().size()));
+        particleSteps += ps.store().size();
+        ps.update(dt);
+        if (Profiler::enabled) {
+            // Les frames fermées sont stockées par le profileur : hors du décompte
+            uint64_t before = allocationCount.load();
+            SUPERNOVA_PROFILE_FRAME();
+            profilerAllocs += allocationCount.load() - before;
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    uint64_t allocs = allocationCount.load() - allocsBefore - profilerAllocs;
+
+    BenchResult result;
+    result.nsPerParticleStep = particleSteps ? ns / double(particleSteps) : 0.0;
+    result.allocsPerFrame = double(allocs) / opt.steps;
+    result.peakRss = peakRssMiB();
+    result.hash = checksum(ps.store());
+    return result;
+}
+
+static bool parseOptions(int argc, char** argv, BenchOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--suite") == 0 && value) {
+            opt.suite = value;
+            ++i;
+        } else if (std::strcmp(arg, "--barnes-hut") == 0) {
+            opt.barnesHut = true;
+        } else if (std::strcmp(arg, "--sph") == 0) {
+            opt.sph = true;
+        } else if (std::strcmp(arg, "--out") == 0 && value) {
+            opt.out = value;
+            ++i;
+        } else if (std::strcmp(arg, "--profile") == 0 && value) {
+            opt.profile = value;
+            ++i;
+        } else if (std::strcmp(arg, "--config") == 0 && value) {
+            opt.config = value;
+            ++i;
+        } else if (std::strcmp(arg, "--sizes") == 0 && value) {
+            opt.sizes.clear();
+            for (const char* p = value; *p;) {
+                char* end = nullptr;
+                opt.sizes.push_back(std::strtoull(p, &end, 10));
+                p = (*end == ',') ? end + 1 : end;
+                if (end == p && *p) return false;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--steps") == 0 && value) {
+            opt.steps = unsigned(std::strtoul(value, nullptr, 10));
+            ++i;
+        } else if (std::strcmp(arg, "--threads") == 0 && value) {
+            opt.threads = unsigned(std::strtoul(value, nullptr, 10));
+            ++i;
+        } else if (std::strcmp(arg, "--seed") == 0 && value) {
+            opt.seed = std::strtoull(value, nullptr, 0);
+            ++i;
+        } else {
+            return false;
+        }
+    }
+    return opt.steps > 0 && (opt.suite == "particles" || opt.suite == "gravity" || opt.suite == "snapshot" ||
+                              opt.suite == "pipeline" || opt.suite == "packing" ||
+                              opt.suite == "depth" || opt.suite == "splat" || opt.suite == "emitter");
+}
+
+// --- Barnes-Hut : précision contre la somme directe et passage à l'échelle ---
+static bool runGravitySuite(const BenchOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    const float thetas[] = {0.3f, 0.5f, 0.7f, 1.0f};
+    // Erreur relative maximale tolérée par theta : ~1.5x le pire échantillon
+    // mesuré de 2k à 1M particules, un critère d'ouverture cassé donne ~1
+    const double maxErrors[] = {0.05, 0.15, 0.4, 0.75};
+    const float softening = 0.05f;
+    bool accurate = true;
+
+    std::printf("%11s %6s %12s %12s %9s %11s %11s %5s\n",
+                "particles", "theta", "build ns/p", "walk ns/p", "nodes", "median err", "max err", "ok");
+
+    ThreadPool pool(opt.threads);
+    for (std::size_t size : opt.sizes) {
+        // Coquille évoluée pendant une demi-seconde
+        const std::unique_ptr<ParticleSystem> ps = evolvedSystem(size, 30, opt);
+        const ParticleStore& s = ps->store();
+        const std::size_t n = s.size();
+        if (n == 0) continue;
+
+        BarnesHut tree(n);
+        std::vector<float> ax(n), ay(n), az(n);
+
+        const int builds = 5;
+        Clock::time_point start = Clock::now();
+        for (int b = 0; b < builds; ++b) tree.build(s.x.data(), s.y.data(), s.z.data(), n, pool);
+        double buildNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / builds;
+
+        // Référence : somme directe en double sur un échantillon
+        const std::size_t samples = std::min<std::size_t>(n, 256);
+        const double mass = 2.0 / double(n);
+        std::vector<double> ref(samples * 3);
+        pool.parallelFor(samples, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                std::size_t i = k * n / samples;
+                double rx = 0.0, ry = 0.0, rz = 0.0;
+                for (std::size_t j = 0; j < n; ++j) {
+                    double dx = double(s.x[j]) - s.x[i], dy = double(s.y[j]) - s.y[i], dz = double(s.z[j]) - s.z[i];
+                    double r2 = dx * dx + dy * dy + dz * dz + double(softening) * softening;
+                    double inv3 = 1.0 / (r2 * std::sqrt(r2));
+                    rx += dx * inv3; ry += dy * inv3; rz += dz * inv3;
+                }
+                ref[k * 3] = rx * mass; ref[k * 3 + 1] = ry * mass; ref[k * 3 + 2] = rz * mass;
+            }
+        });
+
+        for (std::size_t t = 0; t < std::size(thetas); ++t) {
+            const float theta = thetas[t];
+            BarnesHutParams params;
+            params.theta = theta;
+            params.softening = softening;
+            params.particleMass = float(mass);
+
+            start = Clock::now();
+            tree.computeAccelerations(params, ax.data(), ay.data(), az.data(), pool);
+            double walkNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+            std::vector<double> errors(samples);
+            for (std::size_t k = 0; k < samples; ++k) {
+                std::size_t i = k * n / samples;
+                double ex = ax[i] - ref[k * 3], ey = ay[i] - ref[k * 3 + 1], ez = az[i] - ref[k * 3 + 2];
+                double norm = std::sqrt(ref[k * 3] * ref[k * 3] + ref[k * 3 + 1] * ref[k * 3 + 1] +
+                                        ref[k * 3 + 2] * ref[k * 3 + 2]);
+                errors[k] = std::sqrt(ex * ex + ey * ey + ez * ez) / std::max(norm, 1e-30);
+            }
+            std::sort(errors.begin(), errors.end());
+            const bool ok = errors.back() <= maxErrors[t];
+            accurate &= ok;
+
+            std::printf("%11zu %6.2f %12.2f %12.2f %9zu %11.2e %11.2e %5s\n",
+                        n, theta, buildNs / n, walkNs / n, tree.nodeCount(),
+                        errors[samples / 2], errors.back(), ok ? "yes" : "NO");
+            std::fflush(stdout);
+        }
+    }
+    return accurate;
+}
+
+// --- Enregistrement et relecture des snapshots ---
+static bool runSnapshotSuite(const BenchOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = 1.0f / 60.0f;
+    bool exact = true;
+
+    std::printf("%11s %-9s %14s %8s %12s %12s %14s %11s %5s\n",
+                "particles", "encoding", "submit ns/p", "stalls", "file (MiB)", "bytes/p", "replay ns/p", "max err", "ok");
+
+    for (std::size_t size : opt.sizes) {
+        for (SnapshotEncoding encoding : {SnapshotEncoding::Raw, SnapshotEncoding::Quantized}) {
+            const std::unique_ptr<ParticleSystem> system = evolvedSystem(size, 30, opt);
+            ParticleSystem& ps = *system;
+
+            SnapshotWriter writer(size, encoding);
+            if (!writer.open(opt.out.c_str())) {
+                std::fprintf(stderr, "cannot create %s\n", opt.out.c_str());
+                return false;
+            }
+            double submitNs = 0.0;
+            uint64_t particleFrames = 0;
+            for (unsigned int step = 0; step < opt.steps; ++step) {
+                ps.spawnParticles(unsigned(size - ps.store().size()));
+                ps.update(dt);
+                Clock::time_point start = Clock::now();
+                writer.submit(ps.view());
+                submitNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                particleFrames += ps.store().size();
+            }
+            uint64_t stalls = writer.stalls();
+            if (!writer.close()) {
+                std::fprintf(stderr, "write error on %s\n", opt.out.c_str());
+                return false;
+            }
+            std::vector<float> lastX(ps.store().x.data(), ps.store().x.data() + ps.store().size());
+
+            SnapshotReader reader;
+            if (!reader.open(opt.out.c_str())) {
+                std::fprintf(stderr, "cannot map %s\n", opt.out.c_str());
+                return false;
+            }
+            Clock::time_point start = Clock::now();
+            double sum = 0.0;
+            for (std::size_t f = 0; f < reader.frameCount(); ++f) {
+                ParticleView v = reader.frame(f);
+                for (std::size_t i = 0; i < v.count; ++i) sum += v.x[i] + v.life[i];
+            }
+            double replayNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+            // Toutes les frames relues ; raw exact, quantifié à un pas de 16 bits près
+            bool ok = reader.frameCount() == opt.steps;
+            float maxErr = 0.0f;
+            if (ok) {
+                ParticleView last = reader.frame(reader.frameCount() - 1);
+                ok = last.count == lastX.size();
+                for (std::size_t i = 0; i < last.count && i < lastX.size(); ++i) {
+                    maxErr = std::max(maxErr, std::fabs(last.x[i] - lastX[i]));
+                }
+            }
+            float bound = 0.0f;
+            if (encoding == SnapshotEncoding::Quantized && !lastX.empty()) {
+                auto [lo, hi] = std::minmax_element(lastX.begin(), lastX.end());
+                bound = (*hi - *lo) / 65535.0f;
+            }
+            ok &= maxErr <= bound;
+            exact &= ok;
+            double fileBytes = double(writer.bytesWritten());
+            reader.close();
+            std::remove(opt.out.c_str());
+            sink = sum;
+
+            std::printf("%11zu %-9s %14.2f %8llu %12.1f %12.1f %14.2f %11.2e %5s\n",
+                        size, encoding == SnapshotEncoding::Raw ? "raw" : "quantized",
+                        submitNs / particleFrames, (unsigned long long)stalls, fileBytes / (1024.0 * 1024.0),
+                        fileBytes / particleFrames, replayNs / particleFrames, maxErr, ok ? "yes" : "NO");
+            std::fflush(stdout);
+        }
+    }
+    return exact;
+}
+
+// --- Simulation sur son thread contre simulation et rendu en série ---
+static double drawFrame(const ParticleView& v) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < v.count; ++i) sum += v.x[i] + v.y[i] + v.z[i] + v.life[i];
+    return sum;
+}
+
+static bool runPipelineSuite(const BenchOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    SimulationSettings settings;
+    settings.realTime = false;
+    settings.maxSnapshots = opt.steps;
+    bool matched = true;
+
+    std::printf("%11s %16s %16s %9s %11s %8s\n",
+                "particles", "serial ms/int", "threaded ms/int", "frames", "allocs", "match");
+
+    for (std::size_t size : opt.sizes) {
+        const std::unique_ptr<ParticleSystem> serialSystem = evolvedSystem(size, 0, opt);
+        const std::unique_ptr<ParticleSystem> threadedSystem = evolvedSystem(size, 0, opt);
+        ParticleSystem& serial = *serialSystem;
+        ParticleSystem& threaded = *threadedSystem;
+
+        // Série : chaque intervalle est simulé puis dessiné sur le même thread
+        Clock::time_point start = Clock::now();
+        for (unsigned int step = 0; step < opt.steps; ++step) {
+            serial.markPrevious();
+            for (unsigned int s = 0; s < settings.substeps; ++s) serial.update(settings.fixedStep);
+            sink = drawFrame(serial.view());
+        }
+        double serialMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // Pipeline : le thread de simulation publie, celui-ci dessine le dernier snapshot
+        SimulationThread simulation(threaded, settings);
+        start = Clock::now();
+        simulation.start();
+        uint64_t allocsBefore = allocationCount.load();
+        uint64_t frames = 0;
+        while (simulation.running()) {
+            sink = drawFrame(simulation.frame());
+            ++frames;
+        }
+        uint64_t allocs = allocationCount.load() - allocsBefore;
+        simulation.stop();
+        double threadedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        bool match = checksum(serial.store()) == checksum(threaded.store());
+        matched &= match && allocs == 0;
+        std::printf("%11zu %16.3f %16.3f %9llu %11llu %8s\n",
+                    size, serialMs / opt.steps, threadedMs / opt.steps, (unsigned long long)frames,
+                    (unsigned long long)allocs, match ? "yes" : "NO");
+        std::fflush(stdout);
+    }
+    return matched;
+}
+
+// --- Remplissage du buffer d'instances, sans contexte GL ---
+static bool runPackingSuite(const BenchOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    ThreadPool pool(opt.threads);
+    bool allSame = true;
+
+    std::printf("%11s %8s %14s %14s %11s\n", "particles", "threads", "ns/particle", "GB/s", "same bytes");
+
+    for (std::size_t size : opt.sizes) {
+        const std::unique_ptr<ParticleSystem> ps = evolvedSystem(size, 10, opt);
+        const ParticleView frame = ps->view();
+        AlignedBuffer<ParticleInstance> instances(frame.count);
+
+        // [1, end) de longueur impaire : début non aligné et reste scalaire
+        // sur le chemin SSE.
+        const std::size_t begin = 1, end = std::max<std::size_t>(begin, frame.count & ~std::size_t(1));
+        AlignedBuffer<ParticleInstance> reference(frame.count);
+        packInstances(frame, instances.data(), begin, end);
+        packInstancesScalar(frame, reference.data(), begin, end);
+        bool same = std::memcmp(instances.data() + begin, reference.data() + begin,
+                                (end - begin) * sizeof(ParticleInstance)) == 0;
+        allSame &= same;
+
+        for (unsigned int threads : {1u, pool.size()}) {
+            Clock::time_point start = Clock::now();
+            for (unsigned int rep = 0; rep < opt.steps; ++rep) {
+                if (threads == 1) {
+                    packInstances(frame, instances.data(), 0, frame.count);
+                } else {
+                    pool.parallelFor(frame.count, 16384, [&](std::size_t begin, std::size_t end) {
+                        packInstances(frame, instances.data(), begin, end);
+                    });
+                }
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            double perParticle = ns / (double(frame.count) * opt.steps);
+            sink = instances[frame.count / 2].color;
+
+            std::printf("%11zu %8u %14.3f %14.2f %11s\n", frame.count, threads, perParticle,
+                        sizeof(ParticleInstance) / perParticle, same ? "yes" : "NO");
+            std::fflush(stdout);
+            if (pool.size() == 1) break;
+        }
+    }
+    return allSame;
+}
+
+// --- Tri en profondeur pour le mélange alpha ---
+static bool isBackToFront(const ParticleView& frame, const glm::mat4& view, const uint32_t* order,
+                          std::vector<uint8_t>& seen) {
+    seen.assign(frame.count, 0);
+    float previous = -INFINITY;
+    for (std::size_t k = 0; k < frame.count; ++k) {
+        uint32_t i = order[k];
+        if (i >= frame.count || seen[i]) return false;
+        seen[i] = 1;
+        float depth = view[0][2] * frame.x[i] + view[1][2] * frame.y[i] + view[2][2] * frame.z[i] + view[3][2];
+        if (depth < previous) return false;
+        previous = depth;
+    }
+    return true;
+}
+
+static bool runDepthSuite(const BenchOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = 1.0f / 60.0f;
+    ThreadPool pool(opt.threads);
+    std::vector<uint8_t> seen;
+    bool allValid = true;
+
+    std::printf("%11s %-8s %12s %16s %8s\n", "particles", "frames", "ms/sort", "sorted pack ns/p", "valid");
+
+    for (std::size_t size : opt.sizes) {
+        for (bool live : {true, false}) {             // sinon : frame figée (relecture en pause), caméra qui tourne
+            const std::unique_ptr<ParticleSystem> system = evolvedSystem(size, 30, opt);
+            ParticleSystem& ps = *system;
+
+            DepthSorter sorter(size);
+            AlignedBuffer<ParticleInstance> staged(size), instances(size);
+
+            double sortNs = 0.0, packNs = 0.0;
+            uint64_t packed = 0;
+            bool valid = true;
+            for (unsigned int frame = 0; frame < opt.steps; ++frame) {
+                if (live) {
+                    ps.spawnParticles(unsigned(size - ps.store().size()));
+                    ps.update(dt);
+                }
+                glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 15.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+                view = glm::rotate(view, glm::radians(frame * 10.0f * dt), glm::vec3(0.0f, 1.0f, 0.0f));
+                const ParticleView v = ps.view();
+
+                Clock::time_point start = Clock::now();
+                const uint32_t* order = sorter.sort(v, view, pool);
+                sortNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+                start = Clock::now();
+                pool.parallelFor(v.count, 16384, [&](std::size_t begin, std::size_t end) {
+                    packInstances(v, staged.data(), begin, end);
+                });
+                pool.parallelFor(v.count, 16384, [&](std::size_t begin, std::size_t end) {
+                    permuteInstances(staged.data(), order, instances.data(), begin, end);
+                });
+                packNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                packed += v.count;
+
+                if (frame % 16 == 0 || frame + 1 == opt.steps) valid &= isBackToFront(v, view, order, seen);
+            }
+
+            allValid &= valid;
+            std::printf("%11zu %-8s %12.3f %16.3f %8s\n", size, live ? "live" : "paused",
+                        sortNs / opt.steps * 1e-6, packNs / packed, valid ? "yes" : "NO");
+            std::fflush(stdout);
+        }
+    }
+    return allValid;
+}
+
+// --- Rendu CPU en tuiles, image 4K ---
+static bool runSplatSuite(const BenchOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = 1.0f / 60.0f;
+    const int width = 3840, height = 2160;
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), float(width) / float(height), 0.1f, 100.0f);
+
+    bool allStable = true;
+
+    std::printf("%11s %12s %12s %14s %14s\n", "particles", "ms/frame", "on screen", "tile entries", "thread-stable");
+
+    for (std::size_t size : opt.sizes) {
+        const std::unique_ptr<ParticleSystem> system = evolvedSystem(size, 30, opt);
+        ParticleSystem& ps = *system;
+
+        SplatRenderer renderer(width, height, size, opt.threads);
+        double ns = 0.0, onScreen = 0.0, entries = 0.0;
+        glm::mat4 view;
+        for (unsigned int frame = 0; frame < opt.steps; ++frame) {
+            ps.spawnParticles(unsigned(size - ps.store().size()));
+            ps.update(dt);
+            view = glm::lookAt(glm::vec3(0.0f, 0.0f, 15.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            view = glm::rotate(view, glm::radians(frame * 10.0f * dt), glm::vec3(0.0f, 1.0f, 0.0f));
+
+            Clock::time_point start = Clock::now();
+            renderer.render(ps.view(), view, projection);
+            ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            onScreen += double(renderer.splatCount());
+            entries += double(renderer.binnedCount());
+        }
+
+        // Même image sur un seul thread : le découpage ne change ni l'ordre ni les arrondis
+        SplatRenderer single(width, height, size, 1);
+        single.render(ps.view(), view, projection);
+        const bool stable = std::memcmp(single.pixels(), renderer.pixels(),
+                                        std::size_t(width) * height * 4 * sizeof(float)) == 0;
+        allStable &= stable;
+
+        std::printf("%11zu %12.1f %12.0f %14.0f %14s\n", size, ns / opt.steps * 1e-6, onScreen / opt.steps,
+                    entries / opt.steps, stable ? "yes" : "NO");
+        std::fflush(stdout);
+    }
+    return allStable;
+}
+
+// --- Génération par lots et supernovas côte à côte ---
+static bool runEmitterSuite(const BenchOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = 1.0f / 60.0f;
+
+    std::vector<SupernovaConfig> configs;
+    if (!opt.config.empty()) {
+        std::string error;
+        if (!loadSupernovaConfig(opt.config.c_str(), configs, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return false;
+        }
+    } else {
+        // Balayage par défaut : plus d'anneaux d'une instance à l'autre
+        for (int k = 0; k < 4; ++k) {
+            SupernovaConfig config;
+            config.name = "rings-" + std::to_string(k);
+            config.particles = 100000;
+            config.seed = opt.seed + uint64_t(k);
+            config.emitter.center = glm::vec3(-6.0f + 4.0f * float(k), 0.0f, 0.0f);
+            config.emitter.ringProbability = 0.1f + 0.2f * float(k);
+            configs.push_back(config);
+        }
+    }
+
+    bool ok = true;
+    std::printf("%11s %15s %15s %10s %10s\n", "particles", "simd ns/part", "scalar ns/part", "same bits", "burst ms");
+    for (std::size_t size : opt.sizes) {
+        const EmitterSettings emitter;
+        std::vector<float> fx(emitter.filaments), fy(fx.size()), fz(fx.size());
+        for (std::size_t i = 0; i < fx.size(); ++i) {
+            const float theta = float(i) / float(fx.size()) * 6.28f;
+            fx[i] = 0.8f * std::cos(theta); fy[i] = 0.8f * std::sin(theta); fz[i] = 0.6f;
+        }
+        SpawnParams params;
+        params.seed = opt.seed;
+        params.filamentX = fx.data(); params.filamentY = fy.data(); params.filamentZ = fz.data();
+
+        ParticleStore simd(size), scalar(size);
+        simd.append(size);
+        scalar.append(size);
+        spawnShell(simd, 0, size, 0, emitter, params);        // pages touchées hors mesure
+        spawnShellScalar(scalar, 0, size, 0, emitter, params);
+        double simdNs = 0.0, scalarNs = 0.0;
+        for (unsigned int rep = 0; rep < opt.steps; ++rep) {
+            Clock::time_point start = Clock::now();
+            spawnShell(simd, 0, size, uint64_t(rep) * size, emitter, params);
+            simdNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            start = Clock::now();
+            spawnShellScalar(scalar, 0, size, uint64_t(rep) * size, emitter, params);
+            scalarNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+        const bool same = checksum(simd) == checksum(scalar);
+        ok &= same;
+
+        ParticleSystem ps(unsigned(size), opt.threads, opt.seed);
+        Clock::time_point start = Clock::now();
+        ps.spawnParticles(unsigned(size));
+        const double burstMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        const double generated = double(size) * opt.steps;
+        std::printf("%11zu %15.2f %15.2f %10s %10.2f\n", size, simdNs / generated, scalarNs / generated,
+                    same ? "yes" : "NO", burstMs);
+        std::fflush(stdout);
+    }
+
+    // Une instance par thread, chacune avec son propre pool d'un thread
+    std::vector<std::unique_ptr<ParticleSystem>> systems;
+    for (const SupernovaConfig& config : configs) {
+        systems.push_back(std::make_unique<ParticleSystem>(config.particles, 1));
+        applySupernovaConfig(*systems.back(), config);
+    }
+    std::vector<double> stepMs(systems.size(), 0.0);
+    auto run = [&](ParticleSystem& ps, unsigned int capacity) {
+        for (unsigned int step = 0; step < opt.steps; ++step) {
+            ps.spawnParticles(unsigned(capacity - ps.store().size()));
+            ps.update(dt);
+        }
+    };
+
+    ThreadPool pool(opt.threads);
+    Clock::time_point start = Clock::now();
+    pool.parallelFor(systems.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            Clock::time_point instanceStart = Clock::now();
+            run(*systems[i], configs[i].particles);
+            stepMs[i] = std::chrono::duration<double, std::milli>(Clock::now() - instanceStart).count() / opt.steps;
+        }
+    });
+    const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / opt.steps;
+
+    std::printf("\n%-16s %11s %11s %16s %12s\n", "instance", "particles", "ms/step", "checksum", "independent");
+    for (std::size_t i = 0; i < systems.size(); ++i) {
+        ParticleSystem alone(configs[i].particles, 1);
+        applySupernovaConfig(alone, configs[i]);
+        run(alone, configs[i].particles);
+        const uint64_t hash = checksum(systems[i]->store());
+        const bool match = hash == checksum(alone.store());
+        ok &= match;
+        std::printf("%-16s %11zu %11.3f %016llx %12s\n", configs[i].name.c_str(), systems[i]->store().size(),
+                    stepMs[i], (unsigned long long)hash, match ? "yes" : "NO");
+    }
+    std::printf("%zu instances on %u threads: %.3f ms per step of all of them\n",
+                systems.size(), pool.size(), wallMs);
+    return ok;
+}
+
+// --- integrateParticles() contre le chemin scalaire de référence ---
+// Both paths step copies of the same store for every <pull, field> variant, over
+// a range that starts unaligned and is not a multiple of 8 long; streams and
+// dead lists must match bit for bit.
+static bool checkIntegrationKernels(uint64_t seed) {
+    const std::size_t n = 1006, begin = 3, end = n;
+    std::vector<float> accel(n), gravity(n), fieldX(n), fieldY(n), fieldZ(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        CounterRng rng(seed, i, 0, RngDomain::Integrate);
+        accel[i] = 0.4f + rng.uniform() * 0.2f;
+        gravity[i] = -0.2f + rng.uniform() * 0.1f;
+        fieldX[i] = rng.uniform() * 2.0f - 1.0f;
+        fieldY[i] = rng.uniform() * 2.0f - 1.0f;
+        fieldZ[i] = rng.uniform() * 2.0f - 1.0f;
+    }
+    auto fill = [&](ParticleStore& s) {
+        s.append(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            CounterRng rng(seed, i, 0, RngDomain::Spawn);
+            s.x[i] = rng.uniform() * 8.0f - 4.0f;
+            s.y[i] = rng.uniform() * 8.0f - 4.0f;
+            s.z[i] = rng.uniform() * 8.0f - 4.0f;
+            s.vx[i] = rng.uniform() * 2.0f - 1.0f;
+            s.vy[i] = rng.uniform() * 2.0f - 1.0f;
+            s.vz[i] = rng.uniform() * 2.0f + 0.01f;   // jamais nulle : normalize(v) reste défini
+            s.life[i] = i % 3 == 0 ? rng.uniform() * 0.03f : 1.0f + rng.uniform();  // un tiers meurt
+        }
+    };
+
+    IntegrationParams params;
+    params.deltaTime = 1.0f / 60.0f;
+    params.centerX = 0.5f;
+    params.centerY = -0.25f;
+    params.centerZ = 0.125f;
+    std::vector<uint32_t> deadSimd(n), deadScalar(n);
+    for (int variant = 0; variant < 4; ++variant) {
+        IntegrationInputs inputs;
+        inputs.accel = accel.data();
+        if (variant & 1) inputs.gravity = gravity.data();
+        if (variant & 2) {
+            inputs.fieldX = fieldX.data();
+            inputs.fieldY = fieldY.data();
+            inputs.fieldZ = fieldZ.data();
+        }
+        ParticleStore simd(n), scalar(n);
+        fill(simd);
+        fill(scalar);
+        const std::size_t deadA = integrateParticles(simd, begin, end, inputs, params, deadSimd.data());
+        const std::size_t deadB = integrateParticlesScalar(scalar, begin, end, inputs, params, deadScalar.data());
+        if (deadA != deadB || deadA == 0 ||
+            std::memcmp(deadSimd.data(), deadScalar.data(), deadA * sizeof(uint32_t)) != 0) {
+            return false;
+        }
+        const AlignedBuffer<float> ParticleStore::* streams[] = {
+            &ParticleStore::x, &ParticleStore::y, &ParticleStore::z,
+            &ParticleStore::vx, &ParticleStore::vy, &ParticleStore::vz, &ParticleStore::life};
+        for (auto stream : streams) {
+            if (std::memcmp((simd.*stream).data(), (scalar.*stream).data(), n * sizeof(float)) != 0) return false;
+        }
+    }
+    return true;
+}
+
+// --- ThreadPool::resize() : aucun worker ne rejoue le job précédent ---
+// Every round resizes the pool, then counts each item of a parallelFor; an
+// item seen twice or missed fails the check.
+static bool checkPoolResize() {
+    const unsigned int sizes[] = {2, 4, 3, 1, 4, 2};
+    std::vector<uint32_t> visits(10000, 0);
+    ThreadPool pool(2);
+    uint32_t round = 0;
+    for (int repeat = 0; repeat < 50; ++repeat) {
+        for (unsigned int threads : sizes) {
+            pool.resize(threads);
+            std::this_thread::sleep_for(std::chrono::microseconds(100)); // laisse démarrer les workers
+            for (int job = 0; job < 2; ++job) {
+                ++round;
+                pool.parallelFor(visits.size(), 16, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        if (i == begin) std::this_thread::yield();  // élargit les courses
+                        ++visits[i];
+                    }
+                });
+                for (uint32_t v : visits) {
+                    if (v != round) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!parseOptions(argc, argv, opt)) {
+        std::fprintf(stderr, "usage: %s [--suite particles|gravity|snapshot|pipeline|packing|depth|splat|emitter] [--sizes N,N,...]"
+                             " [--steps N] [--threads N] [--seed N] [--barnes-hut] [--sph] [--out FILE] [--profile PREFIX]"
+                             " [--config FILE]\n", argv[0]);
+        return 2;
+    }
+    std::atexit(readSink);
+
+    unsigned int threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (opt.suite == "gravity") {
+        if (opt.sizes.empty()) opt.sizes = {10000, 100000, 1000000};
+        std::printf("supernova_bench  suite=gravity  threads=%u\n\n", threads);
+        if (!runGravitySuite(opt)) {
+            std::fprintf(stderr, "FAIL: Barnes-Hut error above the threshold of its theta\n");
+            return 1;
+        }
+        return 0;
+    }
+    if (opt.suite == "snapshot") {
+        if (opt.sizes.empty()) opt.sizes = {100000, 1000000};
+        std::printf("supernova_bench  suite=snapshot  threads=%u  frames=%u\n\n", threads, opt.steps);
+        if (!runSnapshotSuite(opt)) {
+            std::fprintf(stderr, "FAIL: snapshot round trip lost frames or exceeded the quantization step\n");
+            return 1;
+        }
+        return 0;
+    }
+    if (opt.suite == "depth") {
+        if (opt.sizes.empty()) opt.sizes = {100000, 1000000};
+        std::printf("supernova_bench  suite=depth  threads=%u  frames=%u\n\n", threads, opt.steps);
+        if (!runDepthSuite(opt)) {
+            std::fprintf(stderr, "FAIL: depth order is not a back-to-front permutation\n");
+            return 1;
+        }
+        return 0;
+    }
+    if (opt.suite == "splat") {
+        if (opt.sizes.empty()) opt.sizes = {2000, 100000};
+        std::printf("supernova_bench  suite=splat  threads=%u  frames=%u\n\n", threads, opt.steps);
+        if (!runSplatSuite(opt)) {
+            std::fprintf(stderr, "FAIL: splat frame depends on the thread count\n");
+            return 1;
+        }
+        return 0;
+    }
+    if (opt.suite == "emitter") {
+        if (opt.sizes.empty()) opt.sizes = {100000, 1000000};
+        std::printf("supernova_bench  suite=emitter  threads=%u  steps=%u\n\n", threads, opt.steps);
+        return runEmitterSuite(opt) ? 0 : 1;
+    }
+    if (opt.suite == "packing") {
+        if (opt.sizes.empty()) opt.sizes = {100000, 1000000, 10000000};
+        std::printf("supernova_bench  suite=packing  threads=%u  repeats=%u\n\n", threads, opt.steps);
+        if (!runPackingSuite(opt)) {
+            std::fprintf(stderr, "FAIL: SSE packing differs from the scalar path\n");
+            return 1;
+        }
+        return 0;
+    }
+    if (opt.suite == "pipeline") {
+        if (opt.sizes.empty()) opt.sizes = {100000, 1000000};
+        std::printf("supernova_bench  suite=pipeline  threads=%u  intervals=%u\n\n", threads, opt.steps);
+        if (!runPipelineSuite(opt)) {
+            std::fprintf(stderr, "FAIL: threaded pipeline diverged from the serial run or allocated\n");
+            return 1;
+        }
+        return 0;
+    }
+
+    if (opt.sizes.empty()) opt.sizes = {10000, 100000, 1000000, 10000000};
+    std::printf("supernova_bench  kernel=%s  threads=%u  steps=%u  gravity=%s  sph=%s\n\n",
+                integrationKernelName(), threads, opt.steps, opt.barnesHut ? "barnes-hut" : "center-pull",
+                opt.sph ? "on" : "off");
+    std::printf("%-8s %11s %18s %13s %15s  %-16s\n",
+                "scenario", "particles", "ns/particle/step", "allocs/frame", "peak RSS (MiB)", "checksum");
+
+    if (!checkPoolResize()) {
+        std::fprintf(stderr, "FAIL: ThreadPool::resize() replayed or lost work\n");
+        return 1;
+    }
+    if (!checkIntegrationKernels(opt.seed)) {
+        std::fprintf(stderr, "FAIL: %s integration kernel differs from the scalar path\n", integrationKernelName());
+        return 1;
+    }
+
+    bool allocated = false;
+    for (std::size_t size : opt.sizes) {
+        for (bool steady : {false, true}) {
+            BenchResult r = runScenario(size, steady, opt);
+            allocated |= r.allocsPerFrame > 0.0;
+            std::printf("%-8s %11zu %18.2f %13.2f %15.1f  %016llx\n",
+                        steady ? "steady" : "burst", size, r.nsPerParticleStep,
+                        r.allocsPerFrame, r.peakRss, (unsigned long long)r.hash);
+            std::fflush(stdout);
+        }
+    }
+
+    if (Profiler::enabled) {
+        std::printf("\n");
+        Profiler::printSummary(stdout);
+        if (!opt.profile.empty() && (!Profiler::writeChromeTrace((opt.profile + ".json").c_str()) ||
+                                     !Profiler::writeCsv((opt.profile + ".csv").c_str()))) {
+            std::fprintf(stderr, "cannot write profile %s.json / .csv\n", opt.profile.c_str());
+        }
+    } else if (!opt.profile.empty()) {
+        std::fprintf(stderr, "--profile ignored: rebuild with -DSUPERNOVA_ENABLE_PROFILER=ON\n");
+    }
+
+    if (allocated) {
+        std::fprintf(stderr, "FAIL: heap allocations during simulation steps\n");
+        return 1;
+    }
+    return 0;
+}
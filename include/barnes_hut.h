@@ -0,0 +1,68 @@
+#ifndef BARNES_HUT_H
+#define BARNES_HUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "aligned_buffer.h"
+#include "radix_sort.h"
+#include "thread_pool.h"
+
+struct BarnesHutParams {
+    float theta = 0.5f;          // opening angle: a cell of width w is used whole when d > w/theta + delta
+    float softening = 0.05f;     // Plummer softening length
+    float particleMass = 1.0f;   // G * mass of one particle (all particles weigh the same)
+};
+
+// Barnes-Hut octree for mutual gravitation, rebuilt from scratch every step.
+// The build sorts particles along a 30-bit Morton curve (10 bits per axis) with
+// a radix sort, then cuts the sorted range into octants. Each level is one
+// linear pass, so the build is O(n). Nodes live in a flat array in depth-first
+// order with a "skip" link, so the walk needs no stack. A subtree is contiguous
+// in memory and so are the particles of a leaf. The opening test uses distance
+// d to the centre of mass, corrected by delta, the distance from the centre of
+// mass to the cell centre (Barnes 1994). This keeps lopsided cells from being
+// approximated too early. For theta <= 1 a cell is never approximated for a
+// particle inside it.
+class BarnesHut {
+public:
+    explicit BarnesHut(std::size_t capacity);
+
+    // Rebuilds the tree over positions [0, count)
+    void build(const float* x, const float* y, const float* z, std::size_t count, ThreadPool& pool);
+
+    // Acceleration on every particle of the last build, written in input order
+    void computeAccelerations(const BarnesHutParams& params, float* ax, float* ay, float* az,
+                              ThreadPool& pool) const;
+
+    std::size_t nodeCount() const { return nodes.size(); }
+
+private:
+    static constexpr unsigned maxLevel = 10;     // 10 bits per axis
+    static constexpr uint32_t leafSize = 8;
+
+    struct Node {
+        float comX, comY, comZ;  // centre de masse
+        float width;             // largeur de la cellule
+        float delta;             // distance centre de masse - centre de la cellule
+        uint32_t begin, end;     // particules [begin, end) dans l'ordre Morton
+        uint32_t next;           // noeud suivant en sautant ce sous-arbre
+        uint32_t leaf;
+    };
+
+    void buildNode(uint32_t begin, uint32_t end, unsigned level);
+
+    std::size_t count = 0;
+    float rootWidth = 0.0f;
+    float origin[3] = {};                        // lower corner of the root cell
+    float cellScale = 0.0f;                      // finest cells per unit length
+
+    AlignedBuffer<uint32_t> codes;               // Morton codes, sorted
+    AlignedBuffer<uint32_t> order;               // sorted slot -> input index
+    AlignedBuffer<float> sx, sy, sz;             // positions in Morton order
+    std::vector<float> blockBounds;              // parallel bounding-box reduction
+    std::vector<Node> nodes;
+    RadixSorter sorter;
+};
+
+#endif
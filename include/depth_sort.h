@@ -0,0 +1,48 @@
+#ifndef DEPTH_SORT_H
+#define DEPTH_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "aligned_buffer.h"
+#include "particle_view.h"
+#include "radix_sort.h"
+#include "thread_pool.h"
+#include "../external/glm/glm.hpp"
+
+// Back-to-front order of a frame for alpha blending, as a permutation of the
+// particle indices: particle data is never moved, the renderer reads it through
+// order(). The key is the view-space depth mapped with floatToSortableKey and
+// every frame is sorted from scratch with a 32-bit LSD radix sort (RadixSorter).
+//
+// Repairing the previous frame's order with insertion sort never beat the radix
+// sort: removals swap particles into new slots, and at the viewer's orbit speed
+// a paused 20k-particle frame already moves particles by tens of ranks per
+// frame. The order is the same at any thread count; scratch memory is
+// allocated up front.
+class DepthSorter {
+public:
+    explicit DepthSorter(std::size_t capacity);
+
+    // Sorts particles [0, min(count, capacity)) of `frame` seen through `view`
+    // (world to camera), farthest first. Returns order().
+    const uint32_t* sort(const ParticleView& frame, const glm::mat4& view, ThreadPool& pool);
+
+    const uint32_t* order() const { return indices.data(); }
+    std::size_t size() const { return count; }
+
+    // Slot of the last order before which a billboard at `position` belongs
+    // (after every particle at the same depth), e.g. the central flash.
+    std::size_t slotFor(const glm::vec3& position) const;
+
+private:
+    static constexpr std::size_t blockSize = 16384;
+
+    std::size_t capacity;
+    std::size_t count = 0;
+    AlignedBuffer<uint32_t> keys;            // depth key of each sorted slot
+    AlignedBuffer<uint32_t> indices;         // sorted slot -> particle index
+    RadixSorter radix;
+    float depthRow[4] = {};                  // third row of the last view matrix
+};
+
+#endif
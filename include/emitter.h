@@ -0,0 +1,67 @@
+#ifndef EMITTER_H
+#define EMITTER_H
+
+#include "../external/glm/glm.hpp"
+
+// Shape and timeline of one supernova. The defaults are the original remnant:
+// an 800-particle burst at 3x speed, a 0.3 s shock wave and a slow trickle
+// along 18 filaments. Descriptors can be loaded from a config file
+// (emitter_config.h) and handed to ParticleSystem::setEmitter().
+//
+// A shell particle draws t in [0, 1) along its filament. Everything else is a
+// linear function of t plus a random jitter:
+//   radius = radiusMin + t * radiusRange + u * radiusJitter
+//   speed  = speedMin  + t * speedRange  + u * speedJitter
+//   life   = lifeMin   + t * lifeRange   + u * lifeJitter
+struct EmitterSettings {
+    glm::vec3 center = glm::vec3(0.0f);
+
+    // Filaments: directions spread evenly around the z axis, tilted from it by
+    // tiltMin + u * tiltRange radians, then bent sideways along t
+    int filaments = 18;
+    float tiltMin = 0.7f;
+    float tiltRange = 0.7f;
+    float bend = 0.7f;
+
+    float radiusMin = 0.1f;
+    float radiusRange = 3.0f;
+    float radiusJitter = 0.2f;
+    float stretchY = 1.3f;                   // ovoid shell
+    float waveAmplitude = 0.2f;              // ripples along the filaments
+    float waveFrequency = 3.0f;
+    float noiseAmplitude = 0.3f;             // vertical distortion
+
+    float ringProbability = 0.10f;           // share of particles pushed onto loops
+    float ringRadius = 0.8f;
+    float ringWobble = 0.5f;
+    float dustProbability = 0.05f;           // share of particles drawn as dark dust
+
+    float speedMin = 0.08f;
+    float speedRange = 1.3f;
+    float speedJitter = 0.12f;
+    float lifeMin = 1.2f;
+    float lifeRange = 2.5f;
+    float lifeJitter = 0.7f;
+
+    // Colours per shell tier (shell_tiers.h); inner and mid blend A -> B along t
+    glm::vec3 coreColor = glm::vec3(1.0f, 1.0f, 1.0f);       // synchrotron
+    glm::vec3 innerColorA = glm::vec3(1.0f, 0.8f, 0.2f);     // sulphur
+    glm::vec3 innerColorB = glm::vec3(0.7f, 1.0f, 0.5f);     // gas
+    glm::vec3 midColorA = glm::vec3(1.0f, 0.2f, 0.2f);
+    glm::vec3 midColorB = glm::vec3(0.4f, 0.7f, 1.0f);       // iron
+    glm::vec3 outerColor = glm::vec3(1.0f, 0.2f, 0.2f);
+    glm::vec3 dustColor = glm::vec3(0.2f, 0.2f, 0.2f);
+
+    // Timeline, in particles per update() and seconds of simulated time
+    unsigned int burst = 800;                // first update only
+    float burstSpeedScale = 3.0f;
+    unsigned int shockPerStep = 100;         // isotropic flash from the center...
+    float shockDuration = 0.3f;              // ...while elapsed() < shockDuration
+    float shockSpeed = 6.0f;
+    float shockSpeedJitter = 2.0f;
+    float shockLife = 0.3f;
+    glm::vec3 shockColor = glm::vec3(1.0f, 1.0f, 1.0f);
+    unsigned int trickle = 5;                // every update, after the dead are removed
+};
+
+#endif
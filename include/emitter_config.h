@@ -0,0 +1,45 @@
+#ifndef EMITTER_CONFIG_H
+#define EMITTER_CONFIG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "emitter.h"
+#include "particle_system.h"
+
+// One supernova of a config file: its pool size, seed, emitter and physics.
+struct SupernovaConfig {
+    std::string name;
+    unsigned int particles = 2000;
+    uint64_t seed = ParticleSystem::defaultSeed;
+    EmitterSettings emitter;
+    GravitySettings gravity;
+    SphSettings sph;
+};
+
+// Reads an INI-style file where every [section] is one supernova:
+//
+//   # keys before the first section are defaults for every section
+//   particles = 20000
+//
+//   [left]
+//   center = -4 0 0
+//   ringProbability = 0.3
+//
+//   [right]
+//   seed = 42
+//   center = 4 0 0
+//   gravity = barnes-hut
+//
+// Keys are the EmitterSettings member names (colours and center take three
+// numbers), plus name-level keys: particles, seed, gravity (center-pull or
+// barnes-hut), theta, softening, gravityMass, sph (on or off), smoothingLength,
+// soundSpeed, viscosityAlpha, viscosityBeta, gasMass. '#' and ';' start
+// comments. Returns false with "path:line: message" in `error` on an unknown
+// key, a bad value or a file without sections; `out` is then left untouched.
+bool loadSupernovaConfig(const char* path, std::vector<SupernovaConfig>& out, std::string& error);
+
+// Seed, emitter, gravity and SPH of `config`; call before the first update().
+void applySupernovaConfig(ParticleSystem& system, const SupernovaConfig& config);
+
+#endif
@@ -9,6 +9,7 @@ struct Particle {
     glm::vec3 velocity;
     glm::vec3 color;
     float life;
+    float density = 0.0f;   // SPH density, 0 when SPH is off
 };
 
 #endif
\ No newline at end of file
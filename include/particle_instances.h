@@ -0,0 +1,34 @@
+#ifndef PARTICLE_INSTANCES_H
+#define PARTICLE_INSTANCES_H
+
+#include <cstddef>
+#include <cstdint>
+#include "particle_view.h"
+
+// One billboard as the GPU reads it from the instance buffer. Size and alpha
+// are derived in the vertex shader from life, density and the distance to the
+// center, so the CPU only converts colours to 8 bits.
+struct ParticleInstance {
+    float x, y, z;
+    float life;
+    uint32_t color;                          // RGBA8, red in the low byte, alpha 255
+    float density;                           // 0 when the frame has no density stream
+};
+
+static_assert(sizeof(ParticleInstance) == 24, "instance layout is shared with the vertex shader");
+
+// Writes instances [begin, end) of `frame` to out[begin, end). Stores are
+// sequential, so `out` may be write-combined GPU memory. Colours are converted
+// 4 at a time with SSE when the build enables it; every path gives the same bytes.
+void packInstances(const ParticleView& frame, ParticleInstance* out, std::size_t begin, std::size_t end);
+
+// Reference scalar path, always available.
+void packInstancesScalar(const ParticleView& frame, ParticleInstance* out, std::size_t begin, std::size_t end);
+
+// out[k] = in[order[k]] for k in [begin, end), e.g. with a DepthSorter order.
+// Reordering packed 24-byte instances touches one cache line per particle
+// where gathering the SoA streams would touch eight.
+void permuteInstances(const ParticleInstance* in, const uint32_t* order, ParticleInstance* out,
+                      std::size_t begin, std::size_t end);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef PARTICLE_KERNELS_H
+#define PARTICLE_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "particle_store.h"
+
+struct IntegrationParams {
+    float deltaTime;
+    float centerX, centerY, centerZ;
+};
+
+// Per-particle input streams for one step, indexed like the store
+struct IntegrationInputs {
+    const float* accel = nullptr;            // radial acceleration factor (required)
+    const float* gravity = nullptr;          // pull toward the center, nullptr = none
+    const float* fieldX = nullptr;           // extra acceleration, e.g. self-gravity,
+    const float* fieldY = nullptr;           // nullptr = none
+    const float* fieldZ = nullptr;
+};
+
+// Advance particles [begin, end) by one step:
+//   v += normalize(v) * accel[i] * dt
+//   v += (center - p) * gravity[i] * dt      (if gravity)
+//   v += field[i] * dt                       (if field)
+//   p += v * dt, life -= dt
+// Indices of particles whose life drops to <= 0 are written in ascending order to
+// dead (room for end - begin entries); returns how many were written.
+// Uses AVX2 or SSE when the build enables them; every path gives the same bits.
+std::size_t integrateParticles(ParticleStore& store, std::size_t begin, std::size_t end,
+                               const IntegrationInputs& inputs, const IntegrationParams& params,
+                               uint32_t* dead);
+
+// Reference scalar path, always available.
+std::size_t integrateParticlesScalar(ParticleStore& store, std::size_t begin, std::size_t end,
+                                     const IntegrationInputs& inputs, const IntegrationParams& params,
+                                     uint32_t* dead);
+
+// "avx2", "sse" or "scalar"
+const char* integrationKernelName();
+
+#endif
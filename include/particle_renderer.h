@@ -0,0 +1,82 @@
+#ifndef PARTICLE_RENDERER_H
+#define PARTICLE_RENDERER_H
+
+#include <cstddef>
+#include "aligned_buffer.h"
+#include "depth_sort.h"
+#include "particle_instances.h"
+#include "particle_system.h"
+#include "particle_view.h"
+#include "thread_pool.h"
+#include "../external/glm/glm.hpp"
+
+// Resolves GL entry points by name, e.g. glfwGetProcAddress
+using GLProc = void (*)();
+using GLProcLoader = GLProc (*)(const char*);
+
+// OpenGL 3.3 core side of the simulation: draws every particle as a textured
+// billboard with a single instanced draw per frame, live from a ParticleSystem
+// or from a recorded frame. The vertex shader (shaders/vertex.glsl) derives
+// size and alpha from the instance data.
+//
+// Instances stream through a ring of three buffer segments, with one fence per
+// segment, so the CPU never overwrites a frame the GPU is still reading. With
+// GL 4.4 or ARB_buffer_storage the ring is mapped once, persistently; without it
+// each segment is mapped unsynchronized when it is filled.
+//
+// Billboards are blended back to front: a DepthSorter orders the frame by view
+// depth, the frame is packed into a staging array, and the instances are copied
+// into the ring in that order.
+//
+// Needs a current context with the GL functions loaded (gladLoadGL); the
+// simulation itself does not.
+class ParticleRenderer {
+public:
+    // Frames over `capacity` particles are truncated. `loader` fetches
+    // glBufferStorage; nullptr keeps the per-frame mapping path. Sorting and
+    // packing run on `pool`, which must outlive the renderer; renderers drawn
+    // from the same thread should share one pool.
+    ParticleRenderer(std::size_t capacity, GLProcLoader loader, ThreadPool& pool);
+    ~ParticleRenderer();
+
+    ParticleRenderer(const ParticleRenderer&) = delete;
+    ParticleRenderer& operator=(const ParticleRenderer&) = delete;
+
+    bool valid() const { return program != 0; }   // false if the shaders did not build
+    bool persistentMapping() const { return persistent; }
+    void setDepthSorting(bool enabled) { depthSorting = enabled; }
+    const DepthSorter& depthSorter() const { return sorter; }
+
+    void render(const ParticleSystem& ps, const glm::mat4& view, const glm::mat4& projection) {
+        render(ps.view(), view, projection);
+    }
+    void render(const ParticleView& frame, const glm::mat4& view, const glm::mat4& projection);
+
+private:
+    static constexpr int ringSegments = 3;
+
+    void loadTexture();
+
+    std::size_t segmentInstances;            // capacity + the central flash
+    unsigned int program = 0;
+    unsigned int vertexArray = 0;
+    unsigned int instanceBuffer = 0;
+    unsigned int textureId = 0;
+    bool persistent = false;
+    ParticleInstance* mapped = nullptr;      // whole ring, persistent mapping only
+    void* fences[ringSegments] = {};         // GLsync of the last draw reading each segment
+    int segment = 0;
+
+    bool depthSorting = true;
+    ThreadPool& pool;                        // sort and packing, not owned
+    DepthSorter sorter;
+    AlignedBuffer<ParticleInstance> staged;  // unsorted instances, before the permutation
+
+    int viewLocation = -1;
+    int projectionLocation = -1;
+    int centerLocation = -1;
+    int densityReferenceLocation = -1;
+    int flashInstanceLocation = -1;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef PARTICLE_SPRITE_H
+#define PARTICLE_SPRITE_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Billboard sprite used when assets/particle2.png cannot be loaded: a white
+// gaussian halo, RGBA8, `size` x `size` texels. Shared by the OpenGL and the
+// CPU renderers so both draw the same particles.
+inline std::vector<unsigned char> gaussianSprite(int size) {
+    std::vector<unsigned char> sprite(std::size_t(size) * size * 4);
+    for (int j = 0; j < size; ++j) {
+        for (int i = 0; i < size; ++i) {
+            float u = (i + 0.5f) / size * 2.0f - 1.0f;
+            float v = (j + 0.5f) / size * 2.0f - 1.0f;
+            float a = std::exp(-4.0f * (u * u + v * v));
+            unsigned char* p = &sprite[(std::size_t(j) * size + i) * 4];
+            p[0] = p[1] = p[2] = 255;
+            p[3] = (unsigned char)(a * 255.0f + 0.5f);
+        }
+    }
+    return sprite;
+}
+
+#endif
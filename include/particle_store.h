@@ -0,0 +1,40 @@
+#ifndef PARTICLE_STORE_H
+#define PARTICLE_STORE_H
+
+#include <cstddef>
+#include "aligned_buffer.h"
+#include "particle.h"
+
+// Structure-of-arrays particle storage. Every attribute is its own aligned
+// stream so the integration loop only touches the data it needs.
+class ParticleStore {
+public:
+    explicit ParticleStore(std::size_t capacity);
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return maxCount; }
+    bool full() const { return count >= maxCount; }
+
+    void push(const Particle& p);            // append one particle (ignored when full)
+    std::size_t append(std::size_t n);        // grow by up to n slots, returns the first new index
+    void set(std::size_t i, const Particle& p);
+    Particle get(std::size_t i) const;        // gather particle i back into AoS form
+    void kill(std::size_t i);                 // O(1): moves the last particle into slot i
+    void clear() { count = 0; }
+
+    // Streams, valid in [0, size())
+    AlignedBuffer<float> x, y, z;
+    AlignedBuffer<float> vx, vy, vz;
+    AlignedBuffer<float> r, g, b;
+    AlignedBuffer<float> life;
+    AlignedBuffer<float> density;            // SPH density (0 when SPH is off)
+    AlignedBuffer<float> px, py, pz;         // position at the last markPrevious(), for interpolation
+
+    void markPrevious(std::size_t begin, std::size_t end); // px/py/pz = x/y/z over [begin, end)
+
+private:
+    std::size_t count = 0;
+    std::size_t maxCount;
+};
+
+#endif
@@ -2,26 +2,110 @@
 #define PARTICLE_SYSTEM_H
 
 #include "../external/glm/glm.hpp"
+#include <cstdint>
+#include <memory>
 #include <vector>
+#include "barnes_hut.h"
+#include "emitter.h"
 #include "particle.h"
+#include "particle_store.h"
+#include "particle_view.h"
+#include "sph.h"
+#include "thread_pool.h"
+
+enum class GravityMode {
+    CenterPull,                              // randomized spring toward the explosion center
+    BarnesHut,                               // mutual gravitation of the ejecta (octree)
+};
+
+struct GravitySettings {
+    GravityMode mode = GravityMode::CenterPull;
+    float theta = 0.5f;                      // Barnes-Hut opening angle
+    float softening = 0.05f;                 // Plummer softening length
+    float totalMass = 2.0f;                  // G * ejecta mass, shared by the live particles
+};
+
+struct SphSettings {
+    bool enabled = false;                    // pressure + viscosity between ejecta particles
+    float smoothingLength = 0.0f;            // kernel radius h, 0 = follows the shell's expansion
+    float soundSpeed = 0.5f;                 // isothermal: p = c^2 * rho
+    float viscosityAlpha = 1.0f;
+    float viscosityBeta = 2.0f;
+    float totalMass = 1.0f;                  // gas mass, shared by the live particles
+};
 
 class ParticleSystem {
 public:
-    ParticleSystem(unsigned int maxParticles);
+    static constexpr uint64_t defaultSeed = 0x9e3779b97f4a7c15ull;
+
+    // threadCount = 0 uses every hardware thread. A given seed produces the same
+    // particles whatever the thread count.
+    ParticleSystem(unsigned int maxParticles, unsigned int threadCount = 0,
+                   uint64_t seed = defaultSeed);
+
+    void setSeed(uint64_t seed);             // call before the first update()
+    void setThreadCount(unsigned int threadCount);
+    unsigned int threadCount() const { return pool.size(); }
+
+    void setGravity(const GravitySettings& settings);
+    const GravitySettings& gravity() const { return gravitySettings; }
+
+    // Shape and timeline of the explosion, call before the first update()
+    void setEmitter(const EmitterSettings& settings);
+    const EmitterSettings& emitter() const { return emitterSettings; }
 
-    void spawnParticle();                    // old single-particle spawn
-    void spawnParticles(unsigned int count = 5); // multi-particle spawn
+    // Density (store().density) then drives spawn colours and render sizes
+    void setSph(const SphSettings& settings);
+    const SphSettings& sph() const { return sphSettings; }
+    float densityReference() const { return sphSolver ? sphSolver->meanDensity() : 0.0f; }
+
+    // Appends up to `count` shell particles in one batch (SIMD, split across the pool)
+    void spawnParticles(unsigned int count = 5);
     void update(float deltaTime);            // update all particles
-    void render();                           // render all particles (OpenGL)
+    void markPrevious();                     // store().px/py/pz = current positions
+
+    const ParticleStore& store() const { return particles; }
+    ParticleView view() const;               // current state, valid until the next update()
+    glm::vec3 center() const { return emitterSettings.center; }
+    float elapsed() const { return explosionTime; } // time since the explosion started
 
 private:
-    std::vector<Particle> particles;
+    ParticleStore particles;                 // SoA storage, capacity = maxParticles
     unsigned int maxParticles;
 
-    // 3D spawn position (center of explosion)
-    float centerX = 0.0f;
-    float centerY = 0.0f;
-    float centerZ = 0.0f;  // NEW: z-coordinate for 3D
+    // Particles are updated in fixed blocks so the kill lists do not depend on
+    // the thread count. Multiple of 8 to keep SIMD lanes aligned.
+    static constexpr std::size_t updateBlock = 4096;
+
+    // Per-step scratch, sized once in the constructor
+    AlignedBuffer<float> accelJitter;        // random factors fed to the integration kernel
+    AlignedBuffer<float> gravityJitter;
+    AlignedBuffer<uint32_t> deadList;        // dead indices of block b start at b * updateBlock
+    AlignedBuffer<uint32_t> blockDead;       // number of dead particles per block
+
+    // Self-gravity and SPH, allocated when first enabled. Both write their
+    // accelerations to the field streams read by the kernel.
+    GravitySettings gravitySettings;
+    std::unique_ptr<BarnesHut> tree;
+    SphSettings sphSettings;
+    std::unique_ptr<SphSolver> sphSolver;
+    AlignedBuffer<float> fieldX, fieldY, fieldZ;
+
+    void allocateField();
+
+    ThreadPool pool;
+    uint64_t seed = defaultSeed;
+    uint32_t stepIndex = 0;                  // counts update() calls, part of the RNG counter
+    uint64_t spawnSerial = 0;                // serial number of the next spawned particle
+
+    EmitterSettings emitterSettings;
+    std::vector<float> filamentX, filamentY, filamentZ; // unit directions, from the seed
+
+    bool explosionDone = false;
+    float explosionTime = 0.0f;
+
+    void buildFilaments();
+    void spawnBatch(unsigned int count, float speedScale);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef PARTICLE_VIEW_H
+#define PARTICLE_VIEW_H
+
+#include "../external/glm/glm.hpp"
+#include <cstddef>
+
+// Read-only frame of particles, from the live simulation or a recording. The
+// streams hold `count` values and stay owned by whoever produced the view.
+struct ParticleView {
+    std::size_t count = 0;
+    const float* x = nullptr;
+    const float* y = nullptr;
+    const float* z = nullptr;
+    const float* vx = nullptr;
+    const float* vy = nullptr;
+    const float* vz = nullptr;
+    const float* r = nullptr;
+    const float* g = nullptr;
+    const float* b = nullptr;
+    const float* life = nullptr;
+    const float* density = nullptr;
+
+    glm::vec3 center = glm::vec3(0.0f);
+    float elapsed = 0.0f;                    // time since the explosion started
+    float densityReference = 0.0f;           // mean SPH density, 0 = tiers follow distance
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <cstdio>
+
+// Frame profiler, compiled in with -DSUPERNOVA_ENABLE_PROFILER=ON (which defines
+// SUPERNOVA_PROFILE=1 for supernova_core and everything linking it). Otherwise
+// every macro below expands to nothing and Profiler is an empty stub, so
+// production builds carry no instrumentation at all.
+//
+//   SUPERNOVA_PROFILE_SCOPE("integrate");          // times the enclosing scope
+//   SUPERNOVA_PROFILE_COUNT("particles killed", n); // adds n to this frame's counter
+//   SUPERNOVA_PROFILE_VALUE("particles alive", n);  // sets this frame's counter
+//   SUPERNOVA_PROFILE_FRAME();                      // closes the frame (render loop)
+//   SUPERNOVA_PROFILE_THREAD();                     // allocates this thread's ring now
+//
+// Names must be string literals. Each thread records its scopes into its own
+// fixed ring buffer (single producer, lock-free); SUPERNOVA_PROFILE_FRAME()
+// drains every ring into per-frame totals and, up to maxTraceEvents, into the
+// trace. A scope that ends while its ring is full is dropped and counted.
+// A thread's ring (about 1.5 MB) is allocated by its first scope, or earlier by
+// SUPERNOVA_PROFILE_THREAD(). ThreadPool workers, the simulation thread, the
+// snapshot writer and the thread that closes frames register when they start,
+// so scopes recorded on them never allocate. Closing a frame may. When a thread
+// exits, its ring is reused by the next thread that registers once endFrame()
+// has drained it; both threads then share one track in the trace.
+
+#if defined(SUPERNOVA_PROFILE) && SUPERNOVA_PROFILE
+
+#include <chrono>
+#include <cstddef>
+
+class Profiler {
+public:
+    static constexpr bool enabled = true;
+    static constexpr int maxNames = 64;            // distinct scope names
+    static constexpr int maxCounters = 16;
+    static constexpr uint32_t ringSize = 1u << 16; // events per thread between two frames
+    static constexpr std::size_t maxTraceEvents = 4u << 20;
+
+    static uint16_t scopeId(const char* name);     // registers a scope name once
+    static uint16_t counterId(const char* name);
+    static void record(uint16_t id, int64_t startNs, int64_t endNs);
+    static void count(uint16_t id, int64_t delta);
+    static void value(uint16_t id, int64_t value);
+    static void endFrame();
+    static void registerThread();                  // ring of the calling thread
+
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Export of every closed frame. Return false if the file cannot be written.
+    static bool writeChromeTrace(const char* path);   // chrome://tracing, Perfetto
+    static bool writeCsv(const char* path);           // one row per frame, ms and counters
+    static void printSummary(std::FILE* out);         // min / p50 / p99 per scope
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(uint16_t id) : id(id), start(Profiler::nowNs()) {}
+    ~ProfileScope() { Profiler::record(id, start, Profiler::nowNs()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    uint16_t id;
+    int64_t start;
+};
+
+#define SUPERNOVA_PROFILE_CONCAT2(a, b) a##b
+#define SUPERNOVA_PROFILE_CONCAT(a, b) SUPERNOVA_PROFILE_CONCAT2(a, b)
+#define SUPERNOVA_PROFILE_SCOPE(name)                                                           \
+    static const uint16_t SUPERNOVA_PROFILE_CONCAT(profileId_, __LINE__) = Profiler::scopeId(name); \
+    ProfileScope SUPERNOVA_PROFILE_CONCAT(profileScope_, __LINE__)(SUPERNOVA_PROFILE_CONCAT(profileId_, __LINE__))
+#define SUPERNOVA_PROFILE_COUNT(name, delta)                                                    \
+    do {                                                                                        \
+        static const uint16_t profileCounter = Profiler::counterId(name);                       \
+        Profiler::count(profileCounter, int64_t(delta));                                        \
+    } while (0)
+#define SUPERNOVA_PROFILE_VALUE(name, v)                                                        \
+    do {                                                                                        \
+        static const uint16_t profileCounter = Profiler::counterId(name);                       \
+        Profiler::value(profileCounter, int64_t(v));                                            \
+    } while (0)
+#define SUPERNOVA_PROFILE_FRAME() Profiler::endFrame()
+#define SUPERNOVA_PROFILE_THREAD() Profiler::registerThread()
+
+#else
+
+class Profiler {
+public:
+    static constexpr bool enabled = false;
+    static bool writeChromeTrace(const char*) { return false; }
+    static bool writeCsv(const char*) { return false; }
+    static void printSummary(std::FILE*) {}
+};
+
+#define SUPERNOVA_PROFILE_SCOPE(name) do {} while (0)
+#define SUPERNOVA_PROFILE_COUNT(name, delta) do {} while (0)
+#define SUPERNOVA_PROFILE_VALUE(name, v) do {} while (0)
+#define SUPERNOVA_PROFILE_FRAME() do {} while (0)
+#define SUPERNOVA_PROFILE_THREAD() do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "thread_pool.h"
+
+// Maps a float to a key whose unsigned order is the float order: flip every bit
+// of negatives, only the sign bit of positives (-0 sorts just below +0).
+inline uint32_t floatToSortableKey(float f) {
+    uint32_t u = std::bit_cast<uint32_t>(f);
+    return u ^ ((u & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+// Stable LSD radix sort of (key, value) pairs, 8 bits per pass. Histograms and
+// scatters run in parallel over fixed-size blocks, so the output is the same for
+// any thread count. Passes where every key has the same digit are skipped.
+// Scratch memory is kept between calls: no allocation once it has grown.
+class RadixSorter {
+public:
+    // Sorts keys[0, count) ascending, applying the same permutation to values.
+    // Only the low keyBits bits of the keys are looked at.
+    void sort(uint32_t* keys, uint32_t* values, std::size_t count, unsigned keyBits,
+              ThreadPool& pool);
+
+    void reserve(std::size_t count);         // presize scratch for up to count pairs
+
+private:
+    static constexpr std::size_t blockSize = 16384;
+
+    std::vector<uint32_t> keyScratch;
+    std::vector<uint32_t> valueScratch;
+    std::vector<uint32_t> offsets;           // [block][256] histogram, then scatter offsets
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers:
+// as easy as 1, 2, 3"). Output depends only on (key, counter), so each particle can
+// draw its own numbers with no shared state: results do not depend on how work is
+// split across threads.
+struct Philox4x32 {
+    static void generate(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = uint64_t(0xD2511F53u) * c0;
+            uint64_t p1 = uint64_t(0xCD9E8D57u) * c2;
+            uint32_t n0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+            c0 = n0; c1 = uint32_t(p1);
+            c2 = n2; c3 = uint32_t(p0);
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+};
+
+// Independent streams for the different places that draw random numbers
+enum class RngDomain : uint32_t {
+    Integrate = 1,
+    Spawn     = 2,
+    Shock     = 3,
+    Filaments = 4,
+};
+
+// Sequential view over one Philox stream, identified by (seed, stream, step, domain).
+class CounterRng {
+public:
+    CounterRng(uint64_t seed, uint64_t stream, uint32_t step, RngDomain domain)
+        : key{uint32_t(seed), uint32_t(seed >> 32)},
+          counter{uint32_t(stream), uint32_t(stream >> 32), step, uint32_t(domain) << 24} {}
+
+    uint32_t next() {
+        if (used == 4) {
+            Philox4x32::generate(counter, key, block);
+            ++counter[3];
+            used = 0;
+        }
+        return block[used++];
+    }
+
+    // Uniform in [0, 1)
+    float uniform() { return float(next() >> 8) * (1.0f / 16777216.0f); }
+
+    // Uniform integer in [0, n)
+    uint32_t below(uint32_t n) { return uint32_t((uint64_t(next()) * n) >> 32); }
+
+private:
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t block[4] = {};
+    int used = 4;
+};
+
+#endif
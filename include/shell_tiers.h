@@ -0,0 +1,37 @@
+#ifndef SHELL_TIERS_H
+#define SHELL_TIERS_H
+
+// Zones of the remnant shared by spawn colours and particle sizes:
+// 0 = hot core, 1 = inner ejecta, 2 = mid shell, 3 = outer shell.
+// shaders/vertex.glsl receives the radii, ratios and sizes as uniforms.
+
+// Outer radius of tiers 0, 1 and 2
+constexpr float tierRadius[3] = { 0.4f, 1.0f, 2.0f };
+
+inline int tierFromDistance(float dist) {
+    if (dist < tierRadius[0]) return 0;
+    if (dist < tierRadius[1]) return 1;
+    if (dist < tierRadius[2]) return 2;
+    return 3;
+}
+
+// Density over the mean above which a particle is in tier 0, 1 or 2
+constexpr float tierDensityRatio[3] = { 3.0f, 1.5f, 0.75f };
+
+// With SPH the zone follows the local gas density relative to the mean:
+// compressed knots read as core, rarefied gas as outer shell.
+inline int tierFromDensity(float density, float meanDensity) {
+    if (meanDensity <= 0.0f) return 3;
+    float ratio = density / meanDensity;
+    if (ratio > tierDensityRatio[0]) return 0;
+    if (ratio > tierDensityRatio[1]) return 1;
+    if (ratio > tierDensityRatio[2]) return 2;
+    return 3;
+}
+
+inline float tierSize(int tier) {
+    static const float sizes[] = { 6.0f, 4.0f, 3.0f, 2.0f };
+    return sizes[tier];
+}
+
+#endif
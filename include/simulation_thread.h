@@ -0,0 +1,98 @@
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "aligned_buffer.h"
+#include "particle_system.h"
+#include "particle_view.h"
+
+class SnapshotWriter;
+
+struct SimulationSettings {
+    float fixedStep = 1.0f / 120.0f;         // dt of every ParticleSystem::update()
+    unsigned int substeps = 2;               // updates per published snapshot
+    unsigned int maxCatchUp = 4;             // snapshots computed per wake-up before dropping time
+    bool realTime = true;                    // false: run as fast as possible (offline)
+    uint64_t maxSnapshots = 0;               // stop after simulating this many snapshots, 0 = never
+};
+
+// Runs a ParticleSystem on its own thread at a fixed timestep, so results do
+// not depend on the display rate, and publishes immutable snapshots through a
+// lock-free triple buffer: the simulation always has a free buffer to fill and
+// the renderer always reads a complete one, neither ever waits.
+//
+// Each snapshot also holds every particle's position at the previous snapshot
+// (ParticleStore::px/py/pz), so frame() interpolates between the last two
+// states from a single buffer. The rendered state is one snapshot interval
+// behind the simulation.
+class SimulationThread {
+public:
+    SimulationThread(ParticleSystem& system, const SimulationSettings& settings = SimulationSettings());
+    ~SimulationThread();                     // stops the thread
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // The system belongs to the simulation thread between start() and stop().
+    // A recorder, if given, receives every snapshot from the simulation thread.
+    // Returns once the thread runs (with its profiler ring, in a profiler build).
+    void start(SnapshotWriter* recorder = nullptr);
+    void stop();
+    bool running() const { return !finished.load(std::memory_order_acquire); }
+
+    // Render thread only: latest snapshot, positions interpolated to now.
+    // Valid until the next call.
+    ParticleView frame();
+
+    uint64_t snapshots() const { return published.load(std::memory_order_relaxed); }
+    uint64_t droppedSnapshots() const { return dropped.load(std::memory_order_relaxed); }
+    float interval() const { return settings.fixedStep * float(settings.substeps); }
+
+private:
+    struct Snapshot {
+        std::size_t count = 0;
+        AlignedBuffer<float> x, y, z, vx, vy, vz, r, g, b, life, density;
+        AlignedBuffer<float> px, py, pz;     // positions at the previous snapshot
+        double time = 0.0;                   // wall time the state is due, seconds since start()
+        float elapsed = 0.0f;
+        glm::vec3 center = glm::vec3(0.0f);
+        float densityReference = 0.0f;
+    };
+
+    void run();
+    void publish(double time);
+    double now() const;
+
+    ParticleSystem& system;
+    SimulationSettings settings;
+    SnapshotWriter* recorder = nullptr;
+
+    // Triple buffer: the writer owns back, the reader owns front, the third
+    // index sits in `ready` with freshBit set when it holds an unread snapshot.
+    static constexpr unsigned freshBit = 4;
+    Snapshot buffers[3];
+    unsigned back = 2;
+    unsigned front = 0;
+    std::atomic<unsigned> ready{1};
+
+    AlignedBuffer<float> ix, iy, iz;         // interpolated positions, render thread only
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable stopCv;
+    std::condition_variable startedCv;
+    bool started = false;                    // guarded by mutex
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> finished{true};
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> dropped{0};
+    std::chrono::steady_clock::time_point epoch;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "aligned_buffer.h"
+#include "particle_view.h"
+
+// Binary recording of a run, one SoA frame per submitted step:
+//
+//   file header (64 B)
+//   frame 0: frame header (128 B), then one stream per attribute, each padded to 64 B
+//   frame 1 ...
+//   frame index: one uint64 file offset per frame (written on close)
+//
+// Every frame starts on a 64-byte boundary, so a mapped raw frame can be read in
+// place with aligned loads. Values are stored in the writer's byte order
+// (little-endian on every supported platform). The header is complete from the
+// first byte written; close() only fills in frameCount and indexOffset. If a
+// recording is cut short, the header has no index and readers walk the frames
+// through their byte sizes.
+
+enum class SnapshotEncoding : uint32_t {
+    Raw = 0,                                 // float streams, replayed without copying
+    Quantized = 1,                           // 16-bit positions/velocities/life, 8-bit colors: ~2x smaller
+};
+
+struct SnapshotFileHeader {
+    char magic[8];                           // "SNOVASNP"
+    uint32_t version;
+    uint32_t encoding;                       // SnapshotEncoding
+    uint64_t capacity;                       // writer capacity: no frame holds more particles
+    uint64_t frameCount;
+    uint64_t indexOffset;                    // 0 = no index
+    uint8_t reserved[24];
+};
+
+struct SnapshotFrameHeader {
+    uint32_t magic;                          // frameMagic
+    uint32_t encoding;
+    uint64_t count;
+    uint64_t byteSize;                       // header + streams, i.e. offset of the next frame
+    float elapsed;
+    float centerX, centerY, centerZ;
+    float densityReference;
+    float reserved0;
+    float lo[7];                             // quantized: x y z vx vy vz life = lo + q * step
+    float step[7];
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(SnapshotFileHeader) == 64, "snapshot file header layout");
+static_assert(sizeof(SnapshotFrameHeader) == 128, "snapshot frame header layout");
+
+constexpr uint32_t snapshotVersion = 1;
+
+// Records frames from a background thread. submit() copies the frame into one
+// of two buffers and returns; encoding and disk I/O happen on the writer thread
+// while the simulation goes on. submit() only waits when the disk falls two
+// frames behind. Frame buffers are allocated up front; only the frame index grows.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::size_t capacity, SnapshotEncoding encoding = SnapshotEncoding::Raw);
+    ~SnapshotWriter();                       // closes the file
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    bool open(const char* path);             // false if the file cannot be created
+    void submit(const ParticleView& frame);  // frames over capacity are truncated
+    bool close();                            // writes the index; false if any write failed
+
+    bool isOpen() const { return file != nullptr; }
+    uint64_t framesWritten() const;
+    uint64_t bytesWritten() const;
+    uint64_t stalls() const;                 // submits that had to wait for the disk
+
+private:
+    static constexpr int streamCount = 11;   // x y z vx vy vz r g b life density
+
+    struct Slot {
+        AlignedBuffer<float> data;           // streamCount * capacity floats
+        SnapshotFrameHeader header;
+        bool queued = false;
+    };
+
+    void writerLoop();
+    void writeFrame(Slot& slot);
+    void writeBytes(const void* bytes, std::size_t size);
+    void writePadding(std::size_t size);
+
+    std::size_t capacity;
+    SnapshotEncoding encoding;
+    std::FILE* file = nullptr;
+    bool ioError = false;
+
+    Slot slots[2];
+    int nextSlot = 0;                        // slot the next submit() fills
+    AlignedBuffer<unsigned char> encoded;    // quantized frame, writer thread only
+    std::vector<uint64_t> index;
+
+    std::thread writer;
+    mutable std::mutex mutex;
+    std::condition_variable queuedCv;        // a slot was queued, or closing
+    std::condition_variable freedCv;         // a slot was written, or the writer started
+    bool closing = false;
+    bool writerStarted = false;
+    uint64_t frames = 0;
+    uint64_t offset = 0;                     // file position, writer thread only
+    uint64_t bytes = 0;                      // offset after the last finished frame
+    uint64_t stallCount = 0;
+};
+
+// Replays a recording by mapping the whole file. Raw frames point straight into
+// the mapping; quantized frames are decoded into a buffer owned by the reader.
+class SnapshotReader {
+public:
+    SnapshotReader() = default;
+    ~SnapshotReader();
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    bool open(const char* path);             // false if missing, truncated or not a snapshot
+    void close();
+
+    std::size_t frameCount() const { return frames; }
+    std::size_t capacity() const { return maxCount; }
+    SnapshotEncoding encoding() const { return fileEncoding; }
+    float frameTime(std::size_t index) const;     // elapsed time of a frame, no decoding
+    std::size_t seek(float elapsed) const;        // last frame at or before `elapsed`
+
+    // Valid until close(); for quantized files, until the next frame() call.
+    ParticleView frame(std::size_t index);
+
+private:
+    const SnapshotFrameHeader& header(std::size_t index) const;
+
+    const unsigned char* base = nullptr;
+    std::size_t length = 0;
+    const uint64_t* offsets = nullptr;       // frame index, in the mapping or in scanned
+    std::vector<uint64_t> scanned;           // rebuilt index when the file has none
+    std::size_t frames = 0;
+    std::size_t maxCount = 0;
+    SnapshotEncoding fileEncoding = SnapshotEncoding::Raw;
+    AlignedBuffer<float> decoded;
+
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif
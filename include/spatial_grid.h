@@ -0,0 +1,58 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "aligned_buffer.h"
+#include "radix_sort.h"
+#include "thread_pool.h"
+
+// Uniform grid over unbounded space for fixed-radius neighbour search. Each row
+// of cells along x is hashed into a power-of-two table (Teschner et al. 2003)
+// and the cells of a row take consecutive buckets, then particles are sorted by
+// bucket. A 3x3x3 neighbourhood is thus 9 contiguous slices of the sorted
+// arrays instead of 27 scattered lookups. Different cells may share a bucket:
+// callers still check distances.
+class SpatialGrid {
+public:
+    struct Range { uint32_t begin, end; };
+
+    SpatialGrid(std::size_t capacity, float cellSize);
+
+    void setCellSize(float size) { cellSize = size; invCellSize = 1.0f / size; }
+    float getCellSize() const { return cellSize; }
+
+    // Rebins positions [0, count). Every buffer is reused, nothing is allocated.
+    void rebuild(const float* x, const float* y, const float* z, std::size_t count, ThreadPool& pool);
+
+    int cellCoord(float v) const { return int(std::floor(v * invCellSize)); }
+    uint32_t hashCell(int ix, int iy, int iz) const {
+        return (uint32_t(ix) + ((uint32_t(iy) * 19349663u) ^ (uint32_t(iz) * 83492791u))) & tableMask;
+    }
+
+    // Non-empty, non-overlapping slices of the sorted arrays covering the 27
+    // cells around (ix, iy, iz); returns how many
+    int neighbourRanges(int ix, int iy, int iz, Range out[27]) const;
+
+    std::size_t size() const { return count; }
+    const uint32_t* order() const { return sortedIndex.data(); } // sorted slot -> particle index
+    const float* sortedX() const { return sx.data(); }
+    const float* sortedY() const { return sy.data(); }
+    const float* sortedZ() const { return sz.data(); }
+
+private:
+    float cellSize;
+    float invCellSize;
+    unsigned tableBits;
+    uint32_t tableMask;
+    std::size_t count = 0;
+
+    AlignedBuffer<uint32_t> keys;                // bucket of each particle, then sorted
+    AlignedBuffer<uint32_t> sortedIndex;
+    AlignedBuffer<uint32_t> bucketStart;         // first sorted slot of each bucket, table + 1 entries
+    AlignedBuffer<float> sx, sy, sz;             // positions in bucket order
+    RadixSorter sorter;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef SPAWN_KERNELS_H
+#define SPAWN_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "emitter.h"
+#include "particle_store.h"
+
+class SphSolver;
+
+struct SpawnParams {
+    uint64_t seed;
+    const float* filamentX;                  // emitter.filaments unit directions
+    const float* filamentY;
+    const float* filamentZ;
+    float speedScale = 1.0f;                 // burstSpeedScale for the initial burst
+    const SphSolver* sph = nullptr;          // tiers from the gas density, if it has one
+};
+
+// Writes the shell particles with serial numbers [serial, serial + count) to
+// slots [first, first + count) of every stream (px/py/pz = position). Each
+// particle draws from its own Philox stream (RngDomain::Spawn, its serial), so
+// the result does not depend on how the slots are split across calls or
+// threads. Particles are generated 4 at a time with SSE: four Philox streams
+// per register and a polynomial sincos; every path gives the same bits.
+void spawnShell(ParticleStore& store, std::size_t first, std::size_t count, uint64_t serial,
+                const EmitterSettings& emitter, const SpawnParams& params);
+
+// Shock-wave particles: isotropic directions from the center (RngDomain::Shock)
+void spawnShock(ParticleStore& store, std::size_t first, std::size_t count, uint64_t serial,
+                const EmitterSettings& emitter, uint64_t seed);
+
+// Reference scalar paths, always available.
+void spawnShellScalar(ParticleStore& store, std::size_t first, std::size_t count, uint64_t serial,
+                      const EmitterSettings& emitter, const SpawnParams& params);
+void spawnShockScalar(ParticleStore& store, std::size_t first, std::size_t count, uint64_t serial,
+                      const EmitterSettings& emitter, uint64_t seed);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SPH_H
+#define SPH_H
+
+#include <cstddef>
+#include "aligned_buffer.h"
+#include "particle_store.h"
+#include "spatial_grid.h"
+#include "thread_pool.h"
+
+struct SphParams {
+    float smoothingLength = 0.0f;    // kernel support radius h (grid cell size), 0 = automatic
+    float soundSpeed = 0.5f;         // isothermal gas: p = c^2 * rho
+    float viscosityAlpha = 1.0f;     // Monaghan artificial viscosity
+    float viscosityBeta = 2.0f;
+    float particleMass = 1.0f;
+    float deltaTime = 0.0f;          // fixed step the result is integrated with, 0 = no cap
+    float targetNeighbours = 32.0f;  // neighbour count the automatic h aims for
+};
+
+// Smoothed-particle hydrodynamics for the ejecta gas: poly6 density, spiky
+// pressure gradient (Müller et al. 2003) and Monaghan artificial viscosity on
+// approaching pairs. Both passes walk particles in grid order, so neighbours
+// are close in memory, and split that walk across the pool.
+//
+// An automatic smoothing length follows the expanding shell: it starts from the
+// mean spacing of a uniform ball with the cloud's RMS radius, then each step
+// scales h toward the target neighbour count measured by the density pass
+// (the filaments are far from uniform, so the first guess is only a seed). With a fixed
+// step the time step cannot shrink, so the Courant condition on forces,
+// dt <= 0.25 * sqrt(h / |a|), is applied the other way round as a cap on |a|.
+class SphSolver {
+public:
+    SphSolver(std::size_t capacity, float smoothingLength);
+
+    // Rebuilds the neighbour grid, writes each particle's density to
+    // store.density and stores (or adds, if accumulate) the pressure and
+    // viscosity acceleration in ax/ay/az.
+    void step(ParticleStore& store, const SphParams& params, float* ax, float* ay, float* az,
+              bool accumulate, ThreadPool& pool);
+
+    // Density at any point from the particles of the last step (0 before the first)
+    float sampleDensity(float x, float y, float z) const;
+    float meanDensity() const { return mean; }
+    float smoothingLength() const { return last.smoothingLength; } // h used by the last step
+    float meanNeighbours() const { return neighbours; }
+
+private:
+    SpatialGrid grid;
+    SphParams last;
+    float mean = 0.0f;
+    float neighbours = 0.0f;                 // mean neighbours per particle, last step
+    float autoLength = 0.0f;                 // automatic h for the next step, 0 = not seeded
+
+    AlignedBuffer<float> svx, svy, svz;      // velocities in grid order
+    AlignedBuffer<float> srho, spress;       // density and p / rho^2 in grid order
+    AlignedBuffer<double> blockSums;         // fixed-block reductions, 4 per block
+
+    float automaticSmoothingLength(const ParticleStore& store, ThreadPool& pool);
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef SPLAT_RENDERER_H
+#define SPLAT_RENDERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "aligned_buffer.h"
+#include "depth_sort.h"
+#include "particle_view.h"
+#include "thread_pool.h"
+#include "../external/glm/glm.hpp"
+
+// CPU counterpart of ParticleRenderer for machines without a GPU. It splats the
+// same textured billboards into a float RGBA framebuffer: size from the shell
+// tiers (shell_tiers.h), alpha from life, and the central flash. Blending is
+// back to front with GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA, as on the GPU.
+//
+// A frame is depth sorted (DepthSorter) and each billboard is projected to a
+// screen rectangle. The rectangles are binned into every 64x64 tile they
+// overlap, keeping the depth order, and the tiles are rasterized in parallel.
+// A tile belongs to one thread, so blending needs no synchronization and its
+// pixels stay in cache. Each pixel is one RGBA SSE register.
+//
+// Tiles are composited front to back, keeping the transmittance left in each
+// pixel; over the black background this gives the back-to-front result. A tile
+// stops early once every pixel lets less than half an 8-bit level through, which
+// removes most of the overdraw of the large billboards near the core.
+//
+// The sprite is sampled bilinearly, clamped to the edge, from the mip level
+// nearest the billboard's footprint (GL_LINEAR_MIPMAP_NEAREST; the GL renderer
+// also blends two levels). Pixels are covered when their center falls inside
+// the billboard, as in GL rasterization. Scratch memory only grows, so frames
+// of a steady size do not allocate.
+class SplatRenderer {
+public:
+    static constexpr int tileSize = 64;
+
+    // Frames over `capacity` particles are truncated.
+    SplatRenderer(int width, int height, std::size_t capacity, unsigned int threadCount = 0);
+
+    // RGBA8 sprite, top row first, as decoded from a PNG. Until one is set the
+    // renderer uses gaussianSprite(), like ParticleRenderer without its texture.
+    bool setSprite(int width, int height, const unsigned char* rgba);
+
+    // Clears to black and draws the frame. The projection must be a
+    // perspective or orthographic one (no shear).
+    void render(const ParticleView& frame, const glm::mat4& view, const glm::mat4& projection);
+
+    int width() const { return frameWidth; }
+    int height() const { return frameHeight; }
+    unsigned int threadCount() const { return pool.size(); }
+
+    // Last frame, top row first: width * height RGBA floats in [0, 1], the color
+    // as displayed over black and the coverage as alpha.
+    const float* pixels() const { return framebuffer.data(); }
+    // Last frame as 8-bit RGB, width * height * 3 bytes, top row first.
+    void resolve(unsigned char* rgb);
+
+    std::size_t splatCount() const { return drawn; }       // billboards on screen, last frame
+    std::size_t binnedCount() const { return binned; }     // (billboard, tile) pairs, last frame
+
+private:
+    struct Splat {
+        float x0, y0;                        // top-left corner of the billboard, pixels
+        float texelsX, texelsY;              // sprite texels per pixel at `level`
+        int px0, py0, px1, py1;              // covered pixels, end exclusive (empty if culled)
+        float color[4];                      // r, g, b, alpha
+        int level;
+    };
+
+    struct SpriteLevel {
+        int width, height;
+        std::vector<float> texels;           // (width + 2) x (height + 2) RGBA, edge texels repeated
+    };
+
+    std::size_t project(const ParticleView& frame, const uint32_t* order, std::size_t count,
+                        const glm::mat4& view, const glm::mat4& projection);   // returns splats incl. flash
+    void bin(std::size_t count);
+    void rasterize(int tile);
+
+    int frameWidth;
+    int frameHeight;
+    int tilesX;
+    int tilesY;
+    std::size_t capacity;
+
+    ThreadPool pool;
+    DepthSorter sorter;
+    AlignedBuffer<Splat> splats;             // sorted slot -> billboard, plus the flash
+    AlignedBuffer<float> framebuffer;
+    std::vector<SpriteLevel> sprite;         // mip chain, level 0 first
+
+    std::vector<uint32_t> chunkCounts;       // per binning chunk and tile, then write offsets
+    std::vector<uint32_t> tileStart;         // first entry of each tile in `entries`
+    std::vector<uint32_t> entries;           // splat indices, tile by tile, back to front
+
+    std::size_t drawn = 0;
+    std::size_t binned = 0;
+};
+
+#endif
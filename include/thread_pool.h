@@ -0,0 +1,71 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads running chunked parallel loops. The calling thread
+// takes part in the loop, and chunks are handed out through an atomic counter so
+// faster threads pick up more of them. Dispatch does not allocate: the
+// constructor and resize() return once every worker has started (and, in a
+// profiler build, allocated its ring).
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount = 0); // 0 = one per hardware thread
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads taking part in a loop, caller included
+    unsigned size() const { return unsigned(workers.size()) + 1; }
+    void resize(unsigned threadCount);
+
+    // Calls fn(begin, end) over disjoint ranges covering [0, count). Ranges hold at
+    // least `grain` items. Not reentrant: fn must not call parallelFor itself.
+    template <typename Fn>
+    void parallelFor(std::size_t count, std::size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        if (workers.empty() || count <= grain) {
+            fn(std::size_t(0), count);
+            return;
+        }
+        using F = std::remove_reference_t<Fn>;
+        run(count, grain, [](void* ctx, std::size_t begin, std::size_t end) {
+            (*static_cast<F*>(ctx))(begin, end);
+        }, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+private:
+    using RangeFn = void (*)(void*, std::size_t, std::size_t);
+
+    void start(unsigned threadCount);
+    void stop();
+    void run(std::size_t count, std::size_t grain, RangeFn fn, void* ctx);
+    void runChunks();
+    void workerLoop(uint64_t seen);          // seen = generation at creation
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCv;
+    std::condition_variable doneCv;
+    bool stopping = false;
+    uint64_t generation = 0;
+    unsigned activeWorkers = 0;
+    unsigned startingWorkers = 0;            // created, not yet in workerLoop's wait
+
+    // Current job
+    RangeFn jobFn = nullptr;
+    void* jobCtx = nullptr;
+    std::size_t jobCount = 0;
+    std::size_t jobChunk = 0;
+    std::atomic<std::size_t> nextChunk{0};
+};
+
+#endif
@@ -1,25 +1,149 @@
-#include <GL/gl.h>
-#include <GL/glu.h>    // <-- nécessaire pour gluPerspective et gluLookAt
+#include <glad/gl.h>
+#define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../external/glm/gtc/matrix_transform.hpp"
+#include "emitter_config.h"
 #include "particle_system.h"
+#include "particle_renderer.h"
+#include "snapshot.h"
+#include "simulation_thread.h"
+#include "profiler.h"
+
+// Usage: supernova_simulation [--config FILE] [--record FILE [--quantized]] [--replay FILE] [--frames N]
+//                             [--profile PREFIX]
+// --config runs every supernova of an emitter config file (emitter_config.h) side
+// by side, each on its own simulation thread, drawn back to front; --record needs a
+// config with a single supernova.
+// --frames quits after N frames and prints the mean frame time; it also checks
+// glGetError() after every frame and exits with status 1 if any call failed, so
+// LIBGL_ALWAYS_SOFTWARE=1 supernova_simulation --frames 60 is a smoke test under
+// Mesa llvmpipe.
+// --profile writes PREFIX.json (chrome://tracing) and PREFIX.csv at exit; it needs a
+// build configured with -DSUPERNOVA_ENABLE_PROFILER=ON.
+int main(int argc, char** argv) {
+    const char* configPath = nullptr;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    bool quantized = false;
+    long maxFrames = 0;
+    const char* profilePrefix = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc) configPath = argv[++i];
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+        else if (std::strcmp(argv[i], "--quantized") == 0) quantized = true;
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) maxFrames = std::strtol(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) profilePrefix = argv[++i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [--config FILE] [--record FILE [--quantized]] [--replay FILE] [--frames N]"
+                      << " [--profile PREFIX]" << std::endl;
+            return -1;
+        }
+    }
+    if (profilePrefix && !Profiler::enabled) {
+        std::cerr << "--profile ignored: rebuild with -DSUPERNOVA_ENABLE_PROFILER=ON" << std::endl;
+    }
+
+    // Une supernova par défaut (2000 particules), ou celles du fichier
+    std::vector<SupernovaConfig> supernovas(1);
+    std::string configError;
+    if (configPath && !loadSupernovaConfig(configPath, supernovas, configError)) {
+        std::cerr << configError << std::endl;
+        return -1;
+    }
+    // Un enregistrement ne contient qu'une simulation : pas de choix implicite
+    if (recordPath && supernovas.size() > 1) {
+        std::cerr << "--record needs a config with a single supernova, " << configPath << " has "
+                  << supernovas.size() << std::endl;
+        return -1;
+    }
+
+    // Relecture : les frames sont lues directement dans le fichier projeté
+    SnapshotReader replay;
+    if (replayPath && (!replay.open(replayPath) || replay.frameCount() == 0)) {
+        std::cerr << "cannot replay " << replayPath << std::endl;
+        return -1;
+    }
 
-int main() {
     if (!glfwInit()) return -1;
 
+    // Contexte 3.3 core : le rendu n'utilise plus le pipeline fixe
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+
     GLFWwindow* window = glfwCreateWindow(800, 600, "Supernova Simulation 3D", NULL, NULL);
     if (!window) { glfwTerminate(); return -1; }
 
     glfwMakeContextCurrent(window);
+    if (!gladLoadGL(glfwGetProcAddress)) {
+        std::cerr << "cannot load OpenGL 3.3 functions" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
 
     // Enable depth testing
     glEnable(GL_DEPTH_TEST);
 
-    ParticleSystem ps(2000);  // max 2000 particles for denser nebula
+    // Une simulation, un thread et un renderer par supernova ; la relecture n'en a qu'un.
+    // Les renderers dessinent l'un après l'autre sur ce thread : un seul pool pour tous
+    ThreadPool renderPool;
+    std::vector<std::unique_ptr<ParticleSystem>> systems;
+    std::vector<std::unique_ptr<SimulationThread>> simulations;
+    std::vector<std::unique_ptr<ParticleRenderer>> renderers; // détruits avant le contexte GL
+    if (replay.frameCount() > 0) {
+        renderers.push_back(std::make_unique<ParticleRenderer>(replay.capacity(), glfwGetProcAddress, renderPool));
+    } else {
+        // Les pools se partagent les coeurs
+        const unsigned int threads = supernovas.size() > 1
+            ? std::max(1u, std::thread::hardware_concurrency() / unsigned(supernovas.size())) : 0;
+        for (const SupernovaConfig& config : supernovas) {
+            systems.push_back(std::make_unique<ParticleSystem>(config.particles, threads));
+            applySupernovaConfig(*systems.back(), config);
+            simulations.push_back(std::make_unique<SimulationThread>(*systems.back()));
+            renderers.push_back(std::make_unique<ParticleRenderer>(config.particles, glfwGetProcAddress, renderPool));
+        }
+    }
+    for (const std::unique_ptr<ParticleRenderer>& renderer : renderers) {
+        if (!renderer->valid()) {
+            renderers.clear();
+            glfwTerminate();
+            return -1;
+        }
+    }
+
+    SnapshotWriter recorder(supernovas.front().particles,
+                            quantized ? SnapshotEncoding::Quantized : SnapshotEncoding::Raw);
+    if (recordPath && !recorder.open(recordPath)) {
+        std::cerr << "cannot record to " << recordPath << std::endl;
+    }
+    float playbackTime = 0.0f;
+
+    // Les simulations avancent à pas fixe sur leurs threads, le rendu interpole
+    for (std::size_t i = 0; i < simulations.size(); ++i) {
+        simulations[i]->start(i == 0 && recorder.isOpen() ? &recorder : nullptr);
+    }
+
+    // Ordre de dessin des supernovas, de la plus lointaine à la plus proche
+    std::vector<ParticleView> views(simulations.size());
+    std::vector<std::size_t> drawOrder(simulations.size());
+    std::vector<float> centerDepth(simulations.size());
 
     float lastTime = glfwGetTime();
+    const float startTime = lastTime;
+    long frames = 0;
+    long glErrors = 0;
 
-    while (!glfwWindowShouldClose(window)) {
+    while (!glfwWindowShouldClose(window) && (maxFrames == 0 || frames < maxFrames)) {
         float currentTime = glfwGetTime();
         float deltaTime = currentTime - lastTime;
         lastTime = currentTime;
@@ -32,33 +156,75 @@ int main() {
         glfwGetFramebufferSize(window, &width, &height);
         glViewport(0, 0, width, height);
 
-        glMatrixMode(GL_PROJECTION);
-        glLoadIdentity();
-        gluPerspective(60.0, width / (float)height, 0.1, 100.0); // FOV, aspect, near, far
+        glm::mat4 projection = glm::perspective(glm::radians(60.0f), width / (float)std::max(height, 1),
+                                                0.1f, 100.0f); // FOV, aspect, near, far
 
         // Camera setup
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
-        gluLookAt(
-            0.0, 0.0, 15.0,   // camera position
-            0.0, 0.0, 0.0,    // looking at explosion center
-            0.0, 1.0, 0.0     // up vector
+        glm::mat4 view = glm::lookAt(
+            glm::vec3(0.0f, 0.0f, 15.0f),   // camera position
+            glm::vec3(0.0f, 0.0f, 0.0f),    // looking at explosion center
+            glm::vec3(0.0f, 1.0f, 0.0f)     // up vector
         );
 
         // Optionally rotate camera slowly around Y-axis
         static float angle = 0.0f;
         angle += deltaTime * 10.0f; // degrees per second
-        glRotatef(angle, 0.0f, 1.0f, 0.0f);
+        view = glm::rotate(view, glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        if (replay.frameCount() > 0) {
+            // Rejoue à la vitesse d'enregistrement, en boucle
+            playbackTime += deltaTime;
+            if (playbackTime > replay.frameTime(replay.frameCount() - 1)) playbackTime = 0.0f;
+            renderers.front()->render(replay.frame(replay.seek(playbackTime)), view, projection);
+        } else {
+            // Chaque renderer trie ses particules ; entre supernovas, la plus lointaine d'abord
+            for (std::size_t i = 0; i < simulations.size(); ++i) {
+                views[i] = simulations[i]->frame();
+                centerDepth[i] = (view * glm::vec4(views[i].center, 1.0f)).z;
+                drawOrder[i] = i;
+            }
+            std::sort(drawOrder.begin(), drawOrder.end(),
+                      [&](std::size_t a, std::size_t b) { return centerDepth[a] < centerDepth[b]; });
+            for (std::size_t i : drawOrder) renderers[i]->render(views[i], view, projection);
+        }
 
-        // Update and render particle system
-        ps.update(deltaTime);
-        ps.render();
+        if (maxFrames > 0) {
+            // Plusieurs drapeaux peuvent être levés : on les vide tous
+            for (GLenum error; (error = glGetError()) != GL_NO_ERROR; ++glErrors) {
+                if (glErrors == 0) std::cerr << "GL error 0x" << std::hex << error << std::dec << " in frame " << frames << std::endl;
+            }
+        }
 
         glfwSwapBuffers(window);
         glfwPollEvents();
+        ++frames;
+        SUPERNOVA_PROFILE_FRAME();
+    }
+
+    if (maxFrames > 0 && frames > 0) {
+        std::cout << frames << " frames, " << 1000.0f * (float(glfwGetTime()) - startTime) / frames
+                  << " ms/frame, " << (renderers.front()->persistentMapping() ? "persistent" : "mapped") << " instance ring"
+                  << std::endl;
+        if (glErrors > 0) std::cerr << glErrors << " GL errors" << std::endl;
+    }
+
+    for (const std::unique_ptr<SimulationThread>& simulation : simulations) simulation->stop();
+    if (recorder.isOpen() && !recorder.close()) {
+        std::cerr << "error while writing " << recordPath << std::endl;
+    }
+
+    if (Profiler::enabled) {
+        Profiler::printSummary(stdout);
+        if (profilePrefix) {
+            const std::string prefix = profilePrefix;
+            if (!Profiler::writeChromeTrace((prefix + ".json").c_str()) || !Profiler::writeCsv((prefix + ".csv").c_str())) {
+                std::cerr << "cannot write profile " << prefix << ".json / .csv" << std::endl;
+            }
+        }
     }
 
+    renderers.clear();
     glfwDestroyWindow(window);
     glfwTerminate();
-    return 0;
+    return glErrors > 0 ? 1 : 0;
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #version 330 core
+in vec2 vTexCoord;
+in vec4 vColor;
+uniform sampler2D uSprite;
 out vec4 FragColor;
 void main() {
-    FragColor = vec4(1.0, 0.5, 0.2, 1.0);
+    FragColor = vColor * texture(uSprite, vTexCoord);
 }
@@ -1,5 +1,60 @@
 #version 330 core
-layout(location = 0) in vec2 aPos;
+// Billboard instancié : un quad par particule, taille et alpha calculés ici
+layout(location = 0) in vec4 aPositionLife;   // x y z, life
+layout(location = 1) in vec4 aColor;          // RGBA8 normalisé
+layout(location = 2) in float aDensity;
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+uniform vec3 uCenter;
+uniform float uDensityReference;              // 0 = zones selon la distance au centre
+uniform float uTierSize[4];
+uniform float uTierRadius[3];                 // include/shell_tiers.h
+uniform float uTierDensityRatio[3];
+uniform int uFlashInstance;                   // instance du flash central, -1 sinon
+uniform float uFlashSize;
+
+out vec2 vTexCoord;
+out vec4 vColor;
+
+int tierFromDistance(float dist) {
+    if (dist < uTierRadius[0]) return 0;
+    if (dist < uTierRadius[1]) return 1;
+    if (dist < uTierRadius[2]) return 2;
+    return 3;
+}
+
+int tierFromDensity(float density) {
+    float ratio = density / uDensityReference;
+    if (ratio > uTierDensityRatio[0]) return 0;
+    if (ratio > uTierDensityRatio[1]) return 1;
+    if (ratio > uTierDensityRatio[2]) return 2;
+    return 3;
+}
+
 void main() {
-    gl_Position = vec4(aPos, 0.0, 1.0);
+    // Coins du triangle strip : (-1,-1) (1,-1) (-1,1) (1,1)
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+
+    vec3 position = aPositionLife.xyz;
+    float size;
+    float alpha;
+    if (gl_InstanceID == uFlashInstance) {
+        size = uFlashSize;
+        alpha = aPositionLife.w;
+    } else {
+        int tier = uDensityReference > 0.0 ? tierFromDensity(aDensity)
+                                           : tierFromDistance(length(position - uCenter));
+        size = uTierSize[tier];
+        alpha = clamp(aPositionLife.w, 0.2, 1.0);
+    }
+
+    // Face à la caméra : axes droite et haut lus dans la matrice de vue
+    vec3 right = vec3(uView[0][0], uView[1][0], uView[2][0]);
+    vec3 up = vec3(uView[0][1], uView[1][1], uView[2][1]);
+    vec3 world = position + (right * corner.x + up * corner.y) * size;
+
+    gl_Position = uProjection * uView * vec4(world, 1.0);
+    vTexCoord = corner * 0.5 + 0.5;
+    vColor = vec4(aColor.rgb, alpha);
 }
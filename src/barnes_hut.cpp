@@ -0,0 +1,192 @@
+// src/barnes_hut.cpp
+// Gravité mutuelle par octree de Barnes-Hut (construction Morton, parcours sans pile)
+#include "barnes_hut.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr std::size_t boundsBlock = 16384;
+
+// Spreads the low 10 bits of v so that there are two zero bits between each
+inline uint32_t expandBits(uint32_t v) {
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+} // namespace
+
+BarnesHut::BarnesHut(std::size_t capacity)
+    : codes(capacity), order(capacity), sx(capacity), sy(capacity), sz(capacity)
+{
+    // Feuilles non vides, noeuds internes à deux enfants au moins : au plus
+    // 2n - 1 noeuds, build() ne réalloue jamais
+    nodes.reserve(2 * std::max<std::size_t>(capacity, 1));
+    blockBounds.resize((capacity + boundsBlock - 1) / boundsBlock * 6);
+    sorter.reserve(capacity);
+}
+
+void BarnesHut::build(const float* x, const float* y, const float* z, std::size_t n, ThreadPool& pool) {
+    count = std::min(n, codes.size());
+    nodes.clear();
+    if (count == 0) return;
+
+    // --- Boîte englobante (réduction par blocs) ---
+    const std::size_t blocks = (count + boundsBlock - 1) / boundsBlock;
+    if (blockBounds.size() < blocks * 6) blockBounds.resize(blocks * 6);
+    pool.parallelFor(blocks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t blk = first; blk < last; ++blk) {
+            float lo[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                            std::numeric_limits<float>::max() };
+            float hi[3] = { -lo[0], -lo[1], -lo[2] };
+            std::size_t end = std::min((blk + 1) * boundsBlock, count);
+            for (std::size_t i = blk * boundsBlock; i < end; ++i) {
+                lo[0] = std::min(lo[0], x[i]); hi[0] = std::max(hi[0], x[i]);
+                lo[1] = std::min(lo[1], y[i]); hi[1] = std::max(hi[1], y[i]);
+                lo[2] = std::min(lo[2], z[i]); hi[2] = std::max(hi[2], z[i]);
+            }
+            float* out = blockBounds.data() + blk * 6;
+            for (int a = 0; a < 3; ++a) { out[a] = lo[a]; out[3 + a] = hi[a]; }
+        }
+    });
+    float lo[3], hi[3];
+    for (int a = 0; a < 3; ++a) { lo[a] = blockBounds[a]; hi[a] = blockBounds[3 + a]; }
+    for (std::size_t blk = 1; blk < blocks; ++blk) {
+        const float* b = blockBounds.data() + blk * 6;
+        for (int a = 0; a < 3; ++a) { lo[a] = std::min(lo[a], b[a]); hi[a] = std::max(hi[a], b[3 + a]); }
+    }
+    rootWidth = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2], 1e-6f}) * 1.0001f;
+    for (int a = 0; a < 3; ++a) origin[a] = lo[a];
+    cellScale = float(1u << maxLevel) / rootWidth;
+
+    // --- Codes de Morton ---
+    const float scale = cellScale;
+    const uint32_t maxCell = (1u << maxLevel) - 1;
+    pool.parallelFor(count, 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            uint32_t qx = std::min(uint32_t((x[i] - lo[0]) * scale), maxCell);
+            uint32_t qy = std::min(uint32_t((y[i] - lo[1]) * scale), maxCell);
+            uint32_t qz = std::min(uint32_t((z[i] - lo[2]) * scale), maxCell);
+            codes[i] = (expandBits(qx) << 2) | (expandBits(qy) << 1) | expandBits(qz);
+            order[i] = uint32_t(i);
+        }
+    });
+    sorter.sort(codes.data(), order.data(), count, 3 * maxLevel, pool);
+
+    // Positions recopiées dans l'ordre Morton : feuilles contiguës en mémoire
+    pool.parallelFor(count, 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            uint32_t i = order[k];
+            sx[k] = x[i]; sy[k] = y[i]; sz[k] = z[i];
+        }
+    });
+
+    buildNode(0, uint32_t(count), 0);
+}
+
+// Builds the subtree for sorted particles [begin, end) whose codes share their
+// top `level` octal digits. Levels where every particle falls into the same
+// child are skipped, so each internal node has at least two children.
+void BarnesHut::buildNode(uint32_t begin, uint32_t end, unsigned level) {
+    auto digit = [&](uint32_t k, unsigned lvl) {
+        return (codes[k] >> (3 * (maxLevel - lvl - 1))) & 7u;
+    };
+    while (level < maxLevel && end - begin > leafSize && digit(begin, level) == digit(end - 1, level)) {
+        ++level;
+    }
+
+    uint32_t index = uint32_t(nodes.size());
+    nodes.push_back(Node{});
+
+    double cx = 0.0, cy = 0.0, cz = 0.0;
+    for (uint32_t k = begin; k < end; ++k) { cx += sx[k]; cy += sy[k]; cz += sz[k]; }
+    double inv = 1.0 / double(end - begin);
+    float width = rootWidth / float(1u << level);
+
+    Node node;
+    node.comX = float(cx * inv);
+    node.comY = float(cy * inv);
+    node.comZ = float(cz * inv);
+    node.width = width;
+
+    // Centre géométrique de la cellule, retrouvé depuis une de ses particules
+    const uint32_t maxCell = (1u << maxLevel) - 1;
+    const float p0[3] = { sx[begin], sy[begin], sz[begin] };
+    const float com[3] = { node.comX, node.comY, node.comZ };
+    float delta2 = 0.0f;
+    for (int a = 0; a < 3; ++a) {
+        uint32_t q = std::min(uint32_t((p0[a] - origin[a]) * cellScale), maxCell) >> (maxLevel - level);
+        float centre = origin[a] + (float(q) + 0.5f) * width;
+        delta2 += (com[a] - centre) * (com[a] - centre);
+    }
+    node.delta = std::sqrt(delta2);
+    node.begin = begin;
+    node.end = end;
+    node.leaf = (end - begin <= leafSize || level == maxLevel) ? 1u : 0u;
+
+    if (!node.leaf) {
+        uint32_t childBegin = begin;
+        while (childBegin < end) {
+            unsigned d = digit(childBegin, level);
+            uint32_t childEnd = uint32_t(std::partition_point(
+                codes.data() + childBegin, codes.data() + end,
+                [&](uint32_t c) { return ((c >> (3 * (maxLevel - level - 1))) & 7u) == d; }) - codes.data());
+            buildNode(childBegin, childEnd, level + 1);
+            childBegin = childEnd;
+        }
+    }
+
+    node.next = uint32_t(nodes.size());
+    nodes[index] = node;
+}
+
+void BarnesHut::computeAccelerations(const BarnesHutParams& params, float* ax, float* ay, float* az,
+                                     ThreadPool& pool) const {
+    if (count == 0) return;
+    const float invTheta = 1.0f / params.theta;
+    const float eps2 = params.softening * params.softening;
+    const uint32_t nodeTotal = uint32_t(nodes.size());
+
+    // Parcours dans l'ordre Morton : des particules voisines visitent les mêmes noeuds
+    pool.parallelFor(count, 256, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            const float px = sx[k], py = sy[k], pz = sz[k];
+            float accX = 0.0f, accY = 0.0f, accZ = 0.0f; // en unités de masse d'une particule
+
+            uint32_t n = 0;
+            while (n < nodeTotal) {
+                const Node& node = nodes[n];
+                float dx = node.comX - px, dy = node.comY - py, dz = node.comZ - pz;
+                float d2 = dx * dx + dy * dy + dz * dz;
+
+                if (node.leaf) {
+                    // Somme directe ; la particule elle-même contribue 0 (d = 0)
+                    for (uint32_t j = node.begin; j < node.end; ++j) {
+                        float ex = sx[j] - px, ey = sy[j] - py, ez = sz[j] - pz;
+                        float invR = 1.0f / std::sqrt(ex * ex + ey * ey + ez * ez + eps2);
+                        float invR3 = invR * invR * invR;
+                        accX += ex * invR3; accY += ey * invR3; accZ += ez * invR3;
+                    }
+                    n = node.next;
+                } else if (float open = node.width * invTheta + node.delta; d2 > open * open) {
+                    // Cellule assez lointaine : approximation par son centre de masse
+                    float invR = 1.0f / std::sqrt(d2 + eps2);
+                    float m = float(node.end - node.begin) * invR * invR * invR;
+                    accX += dx * m; accY += dy * m; accZ += dz * m;
+                    n = node.next;
+                } else {
+                    n = n + 1; // premier enfant
+                }
+            }
+
+            uint32_t i = order[k];
+            ax[i] = accX * params.particleMass;
+            ay[i] = accY * params.particleMass;
+            az[i] = accZ * params.particleMass;
+        }
+    });
+}
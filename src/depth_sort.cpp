@@ -0,0 +1,39 @@
+// src/depth_sort.cpp
+// Tri des particules par profondeur, de l'arrière vers l'avant
+#include "depth_sort.h"
+#include <algorithm>
+
+DepthSorter::DepthSorter(std::size_t capacity)
+    : capacity(capacity), keys(capacity), indices(capacity)
+{
+    radix.reserve(capacity);
+}
+
+static inline uint32_t depthKey(const float* row, const ParticleView& frame, std::size_t i) {
+    return floatToSortableKey(row[0] * frame.x[i] + row[1] * frame.y[i] + row[2] * frame.z[i] + row[3]);
+}
+
+const uint32_t* DepthSorter::sort(const ParticleView& frame, const glm::mat4& view, ThreadPool& pool) {
+    // Profondeur en repère caméra : troisième ligne de la matrice de vue (z < 0 devant,
+    // donc les clés croissantes vont du plus loin au plus proche)
+    const float row[4] = { view[0][2], view[1][2], view[2][2], view[3][2] };
+    std::copy(row, row + 4, depthRow);
+    count = std::min(frame.count, capacity);
+
+    uint32_t* k = keys.data();
+    uint32_t* idx = indices.data();
+    pool.parallelFor(count, blockSize, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            k[i] = depthKey(row, frame, i);
+            idx[i] = uint32_t(i);
+        }
+    });
+    radix.sort(k, idx, count, 32, pool);
+    return indices.data();
+}
+
+std::size_t DepthSorter::slotFor(const glm::vec3& position) const {
+    const float* row = depthRow;
+    const uint32_t key = floatToSortableKey(row[0] * position.x + row[1] * position.y + row[2] * position.z + row[3]);
+    return std::size_t(std::upper_bound(keys.data(), keys.data() + count, key) - keys.data());
+}
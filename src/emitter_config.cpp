@@ -0,0 +1,208 @@
+// src/emitter_config.cpp
+// Lecture des descripteurs de supernovas (fichier INI, une section par instance)
+#include "emitter_config.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+
+namespace {
+
+struct FloatKey { const char* name; float EmitterSettings::* member; };
+struct CountKey { const char* name; unsigned int EmitterSettings::* member; };
+struct VectorKey { const char* name; glm::vec3 EmitterSettings::* member; };
+
+const FloatKey floatKeys[] = {
+    {"tiltMin", &EmitterSettings::tiltMin},
+    {"tiltRange", &EmitterSettings::tiltRange},
+    {"bend", &EmitterSettings::bend},
+    {"radiusMin", &EmitterSettings::radiusMin},
+    {"radiusRange", &EmitterSettings::radiusRange},
+    {"radiusJitter", &EmitterSettings::radiusJitter},
+    {"stretchY", &EmitterSettings::stretchY},
+    {"waveAmplitude", &EmitterSettings::waveAmplitude},
+    {"waveFrequency", &EmitterSettings::waveFrequency},
+    {"noiseAmplitude", &EmitterSettings::noiseAmplitude},
+    {"ringProbability", &EmitterSettings::ringProbability},
+    {"ringRadius", &EmitterSettings::ringRadius},
+    {"ringWobble", &EmitterSettings::ringWobble},
+    {"dustProbability", &EmitterSettings::dustProbability},
+    {"speedMin", &EmitterSettings::speedMin},
+    {"speedRange", &EmitterSettings::speedRange},
+    {"speedJitter", &EmitterSettings::speedJitter},
+    {"lifeMin", &EmitterSettings::lifeMin},
+    {"lifeRange", &EmitterSettings::lifeRange},
+    {"lifeJitter", &EmitterSettings::lifeJitter},
+    {"burstSpeedScale", &EmitterSettings::burstSpeedScale},
+    {"shockDuration", &EmitterSettings::shockDuration},
+    {"shockSpeed", &EmitterSettings::shockSpeed},
+    {"shockSpeedJitter", &EmitterSettings::shockSpeedJitter},
+    {"shockLife", &EmitterSettings::shockLife},
+};
+
+const CountKey countKeys[] = {
+    {"burst", &EmitterSettings::burst},
+    {"shockPerStep", &EmitterSettings::shockPerStep},
+    {"trickle", &EmitterSettings::trickle},
+};
+
+const VectorKey vectorKeys[] = {
+    {"center", &EmitterSettings::center},
+    {"coreColor", &EmitterSettings::coreColor},
+    {"innerColorA", &EmitterSettings::innerColorA},
+    {"innerColorB", &EmitterSettings::innerColorB},
+    {"midColorA", &EmitterSettings::midColorA},
+    {"midColorB", &EmitterSettings::midColorB},
+    {"outerColor", &EmitterSettings::outerColor},
+    {"dustColor", &EmitterSettings::dustColor},
+    {"shockColor", &EmitterSettings::shockColor},
+};
+
+std::string trim(const std::string& s) {
+    const char* blank = " \t\r";
+    const std::size_t begin = s.find_first_not_of(blank);
+    if (begin == std::string::npos) return std::string();
+    return s.substr(begin, s.find_last_not_of(blank) - begin + 1);
+}
+
+// Nombres : toute la valeur doit être consommée
+bool parseFloats(const std::string& value, float* out, int count) {
+    const char* p = value.c_str();
+    for (int i = 0; i < count; ++i) {
+        char* end = nullptr;
+        errno = 0;
+        out[i] = std::strtof(p, &end);
+        if (end == p || errno != 0) return false;
+        p = end;
+    }
+    while (*p == ' ' || *p == '\t') ++p;
+    return *p == '\0';
+}
+
+bool parseInteger(const std::string& value, uint64_t max, uint64_t& out) {
+    char* end = nullptr;
+    errno = 0;
+    if (value.empty() || value[0] == '-') return false;
+    out = std::strtoull(value.c_str(), &end, 0);
+    return *end == '\0' && errno == 0 && out <= max;
+}
+
+bool parseSwitch(const std::string& value, const char* on, const char* off, bool& out) {
+    if (value == on) out = true;
+    else if (value == off) out = false;
+    else return false;
+    return true;
+}
+
+// Applique une clé ; "" si tout va bien, sinon le message d'erreur
+std::string applyKey(SupernovaConfig& config, const std::string& key, const std::string& value) {
+    EmitterSettings& e = config.emitter;
+    for (const FloatKey& k : floatKeys) {
+        if (key != k.name) continue;
+        return parseFloats(value, &(e.*k.member), 1) ? std::string() : "expected a number for " + key;
+    }
+    for (const CountKey& k : countKeys) {
+        if (key != k.name) continue;
+        uint64_t n = 0;
+        if (!parseInteger(value, 0xffffffffu, n)) return "expected a particle count for " + key;
+        e.*k.member = unsigned(n);
+        return std::string();
+    }
+    for (const VectorKey& k : vectorKeys) {
+        if (key != k.name) continue;
+        float v[3];
+        if (!parseFloats(value, v, 3)) return "expected three numbers for " + key;
+        e.*k.member = glm::vec3(v[0], v[1], v[2]);
+        return std::string();
+    }
+
+    uint64_t n = 0;
+    bool flag = false;
+    if (key == "filaments") {
+        if (!parseInteger(value, 1u << 16, n) || n == 0) return "filaments must be in [1, 65536]";
+        e.filaments = int(n);
+    } else if (key == "particles") {
+        if (!parseInteger(value, 0xffffffffu, n) || n == 0) return "particles must be a positive count";
+        config.particles = unsigned(n);
+    } else if (key == "seed") {
+        if (!parseInteger(value, ~uint64_t(0), n)) return "expected a 64-bit seed";
+        config.seed = n;
+    } else if (key == "gravity") {
+        if (!parseSwitch(value, "barnes-hut", "center-pull", flag)) return "gravity is center-pull or barnes-hut";
+        config.gravity.mode = flag ? GravityMode::BarnesHut : GravityMode::CenterPull;
+    } else if (key == "sph") {
+        if (!parseSwitch(value, "on", "off", flag)) return "sph is on or off";
+        config.sph.enabled = flag;
+    } else {
+        float* target = nullptr;
+        if (key == "theta") target = &config.gravity.theta;
+        else if (key == "softening") target = &config.gravity.softening;
+        else if (key == "gravityMass") target = &config.gravity.totalMass;
+        else if (key == "smoothingLength") target = &config.sph.smoothingLength;
+        else if (key == "soundSpeed") target = &config.sph.soundSpeed;
+        else if (key == "viscosityAlpha") target = &config.sph.viscosityAlpha;
+        else if (key == "viscosityBeta") target = &config.sph.viscosityBeta;
+        else if (key == "gasMass") target = &config.sph.totalMass;
+        else return "unknown key " + key;
+        if (!parseFloats(value, target, 1)) return "expected a number for " + key;
+    }
+    return std::string();
+}
+
+} // namespace
+
+bool loadSupernovaConfig(const char* path, std::vector<SupernovaConfig>& out, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = std::string(path) + ": cannot open";
+        return false;
+    }
+
+    SupernovaConfig defaults;                // clés avant la première section
+    std::vector<SupernovaConfig> configs;
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        const std::size_t comment = line.find_first_of("#;");
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        const std::string where = std::string(path) + ":" + std::to_string(lineNumber) + ": ";
+        if (line.front() == '[') {
+            const std::string name = trim(line.substr(1, line.size() - 1 - (line.back() == ']')));
+            if (line.back() != ']' || name.empty()) {
+                error = where + "expected [name]";
+                return false;
+            }
+            configs.push_back(defaults);
+            configs.back().name = name;
+            continue;
+        }
+
+        const std::size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            error = where + "expected key = value";
+            return false;
+        }
+        const std::string key = trim(line.substr(0, equals));
+        const std::string message = applyKey(configs.empty() ? defaults : configs.back(), key,
+                                             trim(line.substr(equals + 1)));
+        if (!message.empty()) {
+            error = where + message;
+            return false;
+        }
+    }
+    if (configs.empty()) {
+        error = std::string(path) + ": no [section]";
+        return false;
+    }
+    out = std::move(configs);
+    return true;
+}
+
+void applySupernovaConfig(ParticleSystem& system, const SupernovaConfig& config) {
+    system.setSeed(config.seed);
+    system.setEmitter(config.emitter);
+    system.setGravity(config.gravity);
+    system.setSph(config.sph);
+}
@@ -0,0 +1,58 @@
+// src/particle_instances.cpp
+// Conversion des flux SoA en instances pour le buffer GPU.
+// Les couleurs sont arrondies au plus proche (pair) dans les deux chemins, donc
+// SSE et scalaire donnent les mêmes octets.
+#include "particle_instances.h"
+#include <algorithm>
+#include <cmath>
+
+#if !defined(SUPERNOVA_FORCE_SCALAR)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SUPERNOVA_PACK_SSE 1
+#    include <emmintrin.h>
+#  endif
+#endif
+
+static inline uint32_t toUnorm8(float c) {
+    return uint32_t(std::lrint(std::min(std::max(c, 0.0f), 1.0f) * 255.0f));
+}
+
+static inline ParticleInstance makeInstance(const ParticleView& frame, std::size_t i, uint32_t color) {
+    return ParticleInstance{ frame.x[i], frame.y[i], frame.z[i], frame.life[i], color,
+                             frame.density ? frame.density[i] : 0.0f };
+}
+
+#if defined(SUPERNOVA_PACK_SSE)
+static inline __m128i unorm8x4(const float* c) {
+    const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(c), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    return _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(255.0f)));
+}
+#endif
+
+void packInstancesScalar(const ParticleView& frame, ParticleInstance* out, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        uint32_t color = toUnorm8(frame.r[i]) | (toUnorm8(frame.g[i]) << 8) | (toUnorm8(frame.b[i]) << 16) | 0xff000000u;
+        out[i] = makeInstance(frame, i, color);
+    }
+}
+
+void packInstances(const ParticleView& frame, ParticleInstance* out, std::size_t begin, std::size_t end) {
+    std::size_t i = begin;
+#if defined(SUPERNOVA_PACK_SSE)
+    // Couleurs 4 par 4, puis écriture séquentielle des instances
+    const __m128i opaque = _mm_set1_epi32(int(0xff000000u));
+    for (; i + 4 <= end; i += 4) {
+        __m128i color = _mm_or_si128(_mm_or_si128(unorm8x4(frame.r + i), _mm_slli_epi32(unorm8x4(frame.g + i), 8)),
+                                     _mm_or_si128(_mm_slli_epi32(unorm8x4(frame.b + i), 16), opaque));
+        alignas(16) uint32_t colors[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(colors), color);
+        for (int k = 0; k < 4; ++k) out[i + k] = makeInstance(frame, i + k, colors[k]);
+    }
+#endif
+    packInstancesScalar(frame, out, i, end);   // reste
+}
+
+void permuteInstances(const ParticleInstance* in, const uint32_t* order, ParticleInstance* out,
+                      std::size_t begin, std::size_t end) {
+    for (std::size_t k = begin; k < end; ++k) out[k] = in[order[k]];
+}
@@ -0,0 +1,257 @@
+// src/particle_kernels.cpp
+// Noyau d'intégration des particules (SoA) : AVX2 / SSE / scalaire.
+// Every path performs the same IEEE operations in the same order (no FMA, exact
+// sqrt and division), so SIMD and scalar results are bit-identical.
+#include "particle_kernels.h"
+#include <cmath>
+
+#if !defined(SUPERNOVA_FORCE_SCALAR)
+#  if defined(__AVX2__)
+#    define SUPERNOVA_KERNEL_AVX2 1
+#    include <immintrin.h>
+#  elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SUPERNOVA_KERNEL_SSE 1
+#    include <emmintrin.h>
+#  endif
+#endif
+
+namespace {
+
+struct Streams {
+    float* x; float* y; float* z;
+    float* vx; float* vy; float* vz;
+    float* life;
+};
+
+Streams streamsOf(ParticleStore& s) {
+    return { s.x.data(), s.y.data(), s.z.data(),
+             s.vx.data(), s.vy.data(), s.vz.data(), s.life.data() };
+}
+
+template <bool Pull, bool Field>
+std::size_t integrateRangeScalar(const Streams& s, std::size_t begin, std::size_t end,
+                                 const IntegrationInputs& in, const IntegrationParams& p,
+                                 uint32_t* dead) {
+    const float dt = p.deltaTime;
+    std::size_t deadCount = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        float vx = s.vx[i], vy = s.vy[i], vz = s.vz[i];
+
+        // dir = normalize(v)
+        float invLen = 1.0f / std::sqrt(vx * vx + vy * vy + vz * vz);
+        float dx = vx * invLen, dy = vy * invLen, dz = vz * invLen;
+
+        // Accélération radiale
+        float a = in.accel[i];
+        vx = vx + (dx * a) * dt;
+        vy = vy + (dy * a) * dt;
+        vz = vz + (dz * a) * dt;
+
+        // Rappel vers le centre
+        if constexpr (Pull) {
+            float gr = in.gravity[i];
+            vx = vx + ((p.centerX - s.x[i]) * gr) * dt;
+            vy = vy + ((p.centerY - s.y[i]) * gr) * dt;
+            vz = vz + ((p.centerZ - s.z[i]) * gr) * dt;
+        }
+
+        // Champ d'accélération externe (auto-gravité)
+        if constexpr (Field) {
+            vx = vx + in.fieldX[i] * dt;
+            vy = vy + in.fieldY[i] * dt;
+            vz = vz + in.fieldZ[i] * dt;
+        }
+
+        s.vx[i] = vx; s.vy[i] = vy; s.vz[i] = vz;
+        s.x[i] = s.x[i] + vx * dt;
+        s.y[i] = s.y[i] + vy * dt;
+        s.z[i] = s.z[i] + vz * dt;
+        float life = s.life[i] - dt;
+        s.life[i] = life;
+
+        // Liste des particules mortes (sans branchement)
+        dead[deadCount] = uint32_t(i);
+        deadCount += (life <= 0.0f);
+    }
+    return deadCount;
+}
+
+#if defined(SUPERNOVA_KERNEL_AVX2) || defined(SUPERNOVA_KERNEL_SSE)
+
+// Appends base + k for every set bit k of mask, lowest first
+inline std::size_t appendDead(unsigned mask, std::size_t base, uint32_t* dead, std::size_t deadCount) {
+    for (unsigned k = 0; mask != 0; ++k, mask >>= 1) {
+        dead[deadCount] = uint32_t(base + k);
+        deadCount += (mask & 1u);
+    }
+    return deadCount;
+}
+
+#endif
+
+#if defined(SUPERNOVA_KERNEL_AVX2)
+
+template <bool Pull, bool Field>
+std::size_t integrateRangeSimd(const Streams& s, std::size_t begin, std::size_t end,
+                               const IntegrationInputs& in, const IntegrationParams& p,
+                               uint32_t* dead, std::size_t& deadCount) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 dt = _mm256_set1_ps(p.deltaTime);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 cx = _mm256_set1_ps(p.centerX);
+    const __m256 cy = _mm256_set1_ps(p.centerY);
+    const __m256 cz = _mm256_set1_ps(p.centerZ);
+
+    std::size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 vx = _mm256_loadu_ps(s.vx + i);
+        __m256 vy = _mm256_loadu_ps(s.vy + i);
+        __m256 vz = _mm256_loadu_ps(s.vz + i);
+        __m256 px = _mm256_loadu_ps(s.x + i);
+        __m256 py = _mm256_loadu_ps(s.y + i);
+        __m256 pz = _mm256_loadu_ps(s.z + i);
+
+        __m256 len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)),
+                                    _mm256_mul_ps(vz, vz));
+        __m256 invLen = _mm256_div_ps(one, _mm256_sqrt_ps(len2));
+
+        __m256 a = _mm256_loadu_ps(in.accel + i);
+        vx = _mm256_add_ps(vx, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(vx, invLen), a), dt));
+        vy = _mm256_add_ps(vy, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(vy, invLen), a), dt));
+        vz = _mm256_add_ps(vz, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(vz, invLen), a), dt));
+
+        if constexpr (Pull) {
+            __m256 gr = _mm256_loadu_ps(in.gravity + i);
+            vx = _mm256_add_ps(vx, _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(cx, px), gr), dt));
+            vy = _mm256_add_ps(vy, _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(cy, py), gr), dt));
+            vz = _mm256_add_ps(vz, _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(cz, pz), gr), dt));
+        }
+
+        if constexpr (Field) {
+            vx = _mm256_add_ps(vx, _mm256_mul_ps(_mm256_loadu_ps(in.fieldX + i), dt));
+            vy = _mm256_add_ps(vy, _mm256_mul_ps(_mm256_loadu_ps(in.fieldY + i), dt));
+            vz = _mm256_add_ps(vz, _mm256_mul_ps(_mm256_loadu_ps(in.fieldZ + i), dt));
+        }
+
+        _mm256_storeu_ps(s.vx + i, vx);
+        _mm256_storeu_ps(s.vy + i, vy);
+        _mm256_storeu_ps(s.vz + i, vz);
+        _mm256_storeu_ps(s.x + i, _mm256_add_ps(px, _mm256_mul_ps(vx, dt)));
+        _mm256_storeu_ps(s.y + i, _mm256_add_ps(py, _mm256_mul_ps(vy, dt)));
+        _mm256_storeu_ps(s.z + i, _mm256_add_ps(pz, _mm256_mul_ps(vz, dt)));
+        __m256 life = _mm256_sub_ps(_mm256_loadu_ps(s.life + i), dt);
+        _mm256_storeu_ps(s.life + i, life);
+
+        unsigned mask = unsigned(_mm256_movemask_ps(_mm256_cmp_ps(life, zero, _CMP_LE_OQ)));
+        deadCount = appendDead(mask, i, dead, deadCount);
+    }
+    return i;
+}
+
+#elif defined(SUPERNOVA_KERNEL_SSE)
+
+template <bool Pull, bool Field>
+std::size_t integrateRangeSimd(const Streams& s, std::size_t begin, std::size_t end,
+                               const IntegrationInputs& in, const IntegrationParams& p,
+                               uint32_t* dead, std::size_t& deadCount) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 dt = _mm_set1_ps(p.deltaTime);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 cx = _mm_set1_ps(p.centerX);
+    const __m128 cy = _mm_set1_ps(p.centerY);
+    const __m128 cz = _mm_set1_ps(p.centerZ);
+
+    std::size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 vx = _mm_loadu_ps(s.vx + i);
+        __m128 vy = _mm_loadu_ps(s.vy + i);
+        __m128 vz = _mm_loadu_ps(s.vz + i);
+        __m128 px = _mm_loadu_ps(s.x + i);
+        __m128 py = _mm_loadu_ps(s.y + i);
+        __m128 pz = _mm_loadu_ps(s.z + i);
+
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)),
+                                 _mm_mul_ps(vz, vz));
+        __m128 invLen = _mm_div_ps(one, _mm_sqrt_ps(len2));
+
+        __m128 a = _mm_loadu_ps(in.accel + i);
+        vx = _mm_add_ps(vx, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(vx, invLen), a), dt));
+        vy = _mm_add_ps(vy, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(vy, invLen), a), dt));
+        vz = _mm_add_ps(vz, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(vz, invLen), a), dt));
+
+        if constexpr (Pull) {
+            __m128 gr = _mm_loadu_ps(in.gravity + i);
+            vx = _mm_add_ps(vx, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(cx, px), gr), dt));
+            vy = _mm_add_ps(vy, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(cy, py), gr), dt));
+            vz = _mm_add_ps(vz, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(cz, pz), gr), dt));
+        }
+
+        if constexpr (Field) {
+            vx = _mm_add_ps(vx, _mm_mul_ps(_mm_loadu_ps(in.fieldX + i), dt));
+            vy = _mm_add_ps(vy, _mm_mul_ps(_mm_loadu_ps(in.fieldY + i), dt));
+            vz = _mm_add_ps(vz, _mm_mul_ps(_mm_loadu_ps(in.fieldZ + i), dt));
+        }
+
+        _mm_storeu_ps(s.vx + i, vx);
+        _mm_storeu_ps(s.vy + i, vy);
+        _mm_storeu_ps(s.vz + i, vz);
+        _mm_storeu_ps(s.x + i, _mm_add_ps(px, _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(s.y + i, _mm_add_ps(py, _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(s.z + i, _mm_add_ps(pz, _mm_mul_ps(vz, dt)));
+        __m128 life = _mm_sub_ps(_mm_loadu_ps(s.life + i), dt);
+        _mm_storeu_ps(s.life + i, life);
+
+        unsigned mask = unsigned(_mm_movemask_ps(_mm_cmple_ps(life, zero)));
+        deadCount = appendDead(mask, i, dead, deadCount);
+    }
+    return i;
+}
+
+#endif
+
+template <bool Pull, bool Field>
+std::size_t integrateRange(const Streams& s, std::size_t begin, std::size_t end,
+                           const IntegrationInputs& in, const IntegrationParams& params,
+                           uint32_t* dead) {
+    std::size_t deadCount = 0;
+#if defined(SUPERNOVA_KERNEL_AVX2) || defined(SUPERNOVA_KERNEL_SSE)
+    begin = integrateRangeSimd<Pull, Field>(s, begin, end, in, params, dead, deadCount);
+#endif
+    return deadCount + integrateRangeScalar<Pull, Field>(s, begin, end, in, params, dead + deadCount); // reste
+}
+
+} // namespace
+
+std::size_t integrateParticles(ParticleStore& store, std::size_t begin, std::size_t end,
+                               const IntegrationInputs& inputs, const IntegrationParams& params,
+                               uint32_t* dead) {
+    Streams s = streamsOf(store);
+    bool pull = inputs.gravity != nullptr;
+    bool field = inputs.fieldX != nullptr;
+    if (pull && field) return integrateRange<true, true>(s, begin, end, inputs, params, dead);
+    if (pull) return integrateRange<true, false>(s, begin, end, inputs, params, dead);
+    if (field) return integrateRange<false, true>(s, begin, end, inputs, params, dead);
+    return integrateRange<false, false>(s, begin, end, inputs, params, dead);
+}
+
+std::size_t integrateParticlesScalar(ParticleStore& store, std::size_t begin, std::size_t end,
+                                     const IntegrationInputs& inputs, const IntegrationParams& params,
+                                     uint32_t* dead) {
+    Streams s = streamsOf(store);
+    bool pull = inputs.gravity != nullptr;
+    bool field = inputs.fieldX != nullptr;
+    if (pull && field) return integrateRangeScalar<true, true>(s, begin, end, inputs, params, dead);
+    if (pull) return integrateRangeScalar<true, false>(s, begin, end, inputs, params, dead);
+    if (field) return integrateRangeScalar<false, true>(s, begin, end, inputs, params, dead);
+    return integrateRangeScalar<false, false>(s, begin, end, inputs, params, dead);
+}
+
+const char* integrationKernelName() {
+#if defined(SUPERNOVA_KERNEL_AVX2)
+    return "avx2";
+#elif defined(SUPERNOVA_KERNEL_SSE)
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,309 @@
+// src/particle_renderer.cpp
+// Rendu OpenGL 3.3 core : billboards instanciés, un seul draw par frame
+#define GLAD_GL_IMPLEMENTATION
+#include <glad/gl.h>
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#include "particle_renderer.h"
+#include "particle_sprite.h"
+#include "profiler.h"
+#include "shell_tiers.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../external/soil/include/SOIL/SOIL.h" // Pour le décodage de la texture
+
+#ifndef SUPERNOVA_SHADER_DIR
+#define SUPERNOVA_SHADER_DIR "shaders"
+#endif
+
+// glBufferStorage (GL 4.4) n'est pas dans le loader GL 3.3 de GLFW
+typedef void (GLAD_API_PTR *BufferStorageFn)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+static bool readFile(const std::string& path, std::string& out) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char chunk[4096];
+    std::size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) out.append(chunk, n);
+    std::fclose(f);
+    return true;
+}
+
+static GLuint compileShader(GLenum type, const char* name) {
+    // Cherche d'abord à côté de l'exécutable lancé depuis la racine, puis dans les sources
+    std::string source;
+    if (!readFile(std::string("shaders/") + name, source) &&
+        !readFile(std::string(SUPERNOVA_SHADER_DIR "/") + name, source)) {
+        std::cerr << "cannot read shader " << name << std::endl;
+        return 0;
+    }
+    GLuint shader = glCreateShader(type);
+    const char* text = source.c_str();
+    glShaderSource(shader, 1, &text, nullptr);
+    glCompileShader(shader);
+    GLint ok = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << name << ": " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static GLuint buildProgram() {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, "vertex.glsl");
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, "fragment.glsl");
+    GLuint program = 0;
+    if (vs && fs) {
+        program = glCreateProgram();
+        glAttachShader(program, vs);
+        glAttachShader(program, fs);
+        glLinkProgram(program);
+        GLint ok = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (!ok) {
+            char log[1024];
+            glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+            std::cerr << "particle program: " << log << std::endl;
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (vs) glDeleteShader(vs);
+    if (fs) glDeleteShader(fs);
+    return program;
+}
+
+static bool hasBufferStorage() {
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major > 4 || (major == 4 && minor >= 4)) return true;
+    GLint extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+    for (GLint i = 0; i < extensions; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, GLuint(i)));
+        if (name && std::strcmp(name, "GL_ARB_buffer_storage") == 0) return true;
+    }
+    return false;
+}
+
+ParticleRenderer::ParticleRenderer(std::size_t capacity, GLProcLoader loader, ThreadPool& sharedPool)
+    : segmentInstances(capacity + 1), pool(sharedPool), sorter(capacity), staged(capacity)
+{
+    program = buildProgram();
+    loadTexture();
+
+    if (program) {
+        glUseProgram(program);
+        viewLocation = glGetUniformLocation(program, "uView");
+        projectionLocation = glGetUniformLocation(program, "uProjection");
+        centerLocation = glGetUniformLocation(program, "uCenter");
+        densityReferenceLocation = glGetUniformLocation(program, "uDensityReference");
+        flashInstanceLocation = glGetUniformLocation(program, "uFlashInstance");
+        const float sizes[4] = { tierSize(0), tierSize(1), tierSize(2), tierSize(3) };
+        glUniform1fv(glGetUniformLocation(program, "uTierSize"), 4, sizes);
+        glUniform1fv(glGetUniformLocation(program, "uTierRadius"), 3, tierRadius);
+        glUniform1fv(glGetUniformLocation(program, "uTierDensityRatio"), 3, tierDensityRatio);
+        glUniform1f(glGetUniformLocation(program, "uFlashSize"), tierSize(0));
+        glUniform1i(glGetUniformLocation(program, "uSprite"), 0);
+        glUseProgram(0);
+    }
+
+    // Anneau de trois segments : la frame N s'écrit pendant que le GPU lit N-1 et N-2
+    glGenVertexArrays(1, &vertexArray);
+    glGenBuffers(1, &instanceBuffer);
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+    const GLsizeiptr ringBytes = GLsizeiptr(ringSegments * segmentInstances * sizeof(ParticleInstance));
+    BufferStorageFn bufferStorage = nullptr;
+    if (loader && hasBufferStorage()) {
+        bufferStorage = reinterpret_cast<BufferStorageFn>(loader("glBufferStorage"));
+    }
+    if (bufferStorage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(GL_ARRAY_BUFFER, ringBytes, nullptr, flags);
+        mapped = static_cast<ParticleInstance*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, ringBytes, flags));
+        persistent = mapped != nullptr;
+    }
+    if (!persistent) {
+        // Repli GL 3.3 : stockage mutable, chaque segment est mappé au moment de le remplir
+        glBufferData(GL_ARRAY_BUFFER, ringBytes, nullptr, GL_STREAM_DRAW);
+    }
+
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(0, 1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+ParticleRenderer::~ParticleRenderer() {
+    for (void*& fence : fences) {
+        if (fence) glDeleteSync(static_cast<GLsync>(fence));
+    }
+    if (mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    if (instanceBuffer != 0) glDeleteBuffers(1, &instanceBuffer);
+    if (vertexArray != 0) glDeleteVertexArrays(1, &vertexArray);
+    if (program != 0) glDeleteProgram(program);
+    if (textureId != 0) glDeleteTextures(1, &textureId);
+}
+
+void ParticleRenderer::loadTexture() {
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels = SOIL_load_image("assets/particle2.png", &width, &height, &channels, SOIL_LOAD_RGBA);
+    std::vector<unsigned char> sprite;
+    if (pixels) {
+        // Équivalent de SOIL_FLAG_INVERT_Y
+        sprite.assign(pixels, pixels + std::size_t(width) * height * 4);
+        SOIL_free_image_data(pixels);
+        for (int row = 0; row < height / 2; ++row) {
+            std::swap_ranges(sprite.begin() + std::size_t(row) * width * 4,
+                             sprite.begin() + std::size_t(row + 1) * width * 4,
+                             sprite.begin() + std::size_t(height - 1 - row) * width * 4);
+        }
+    } else {
+        // Texture absente : halo gaussien blanc
+        width = height = 64;
+        sprite = gaussianSprite(width);
+    }
+
+    glGenTextures(1, &textureId);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, sprite.data());
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// --- Rendu : remplissage d'un segment de l'anneau puis un draw instancié ---
+void ParticleRenderer::render(const ParticleView& particles, const glm::mat4& view, const glm::mat4& projection) {
+    if (!program) return;
+    SUPERNOVA_PROFILE_SCOPE("render");
+
+    const std::size_t count = std::min(particles.count, segmentInstances - 1);
+    const bool flash = particles.elapsed < 0.1f;  // flash central (pic lumineux)
+    const std::size_t total = count + (flash ? 1 : 0);
+    if (total == 0) return;
+
+    // De l'arrière vers l'avant : le mélange alpha est correct quel que soit l'angle.
+    // Tri et pré-remballage se font avant d'attendre le GPU.
+    const uint32_t* order = nullptr;
+    if (depthSorting) {
+        {
+            SUPERNOVA_PROFILE_SCOPE("depth sort");
+            order = sorter.sort(particles, view, pool);
+        }
+        SUPERNOVA_PROFILE_SCOPE("pack");
+        pool.parallelFor(count, 16384, [&](std::size_t begin, std::size_t end) {
+            packInstances(particles, staged.data(), begin, end);
+        });
+    }
+
+    // Attend que le GPU ait fini de lire ce segment (trois frames plus tôt)
+    if (void* fence = fences[segment]) {
+        SUPERNOVA_PROFILE_SCOPE("fence wait");
+        GLsync sync = static_cast<GLsync>(fence);
+        while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(sync);
+        fences[segment] = nullptr;
+    }
+
+    const std::size_t first = std::size_t(segment) * segmentInstances;
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    ParticleInstance* out = nullptr;
+    if (persistent) {
+        out = mapped + first;
+    } else {
+        out = static_cast<ParticleInstance*>(glMapBufferRange(
+            GL_ARRAY_BUFFER, GLintptr(first * sizeof(ParticleInstance)), GLsizeiptr(total * sizeof(ParticleInstance)),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+        if (!out) {
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            return;
+        }
+    }
+
+    // Le flash central prend sa place dans l'ordre de profondeur ; sans tri, il passe en dernier
+    const std::size_t flashSlot = flash && order ? sorter.slotFor(particles.center) : count;
+    {
+        SUPERNOVA_PROFILE_SCOPE("upload");
+        if (order) {
+            pool.parallelFor(count, 16384, [&](std::size_t begin, std::size_t end) {
+                // Les instances plus proches que le flash sont décalées d'un cran
+                const std::size_t split = std::clamp(flashSlot, begin, end);
+                permuteInstances(staged.data(), order, out, begin, split);
+                permuteInstances(staged.data(), order, out + 1, split, end);
+            });
+        } else {
+            pool.parallelFor(count, 16384, [&](std::size_t begin, std::size_t end) {
+                packInstances(particles, out, begin, end);
+            });
+        }
+    }
+    SUPERNOVA_PROFILE_COUNT("bytes uploaded", total * sizeof(ParticleInstance));
+    if (flash) {
+        const glm::vec3 c = particles.center;
+        out[flashSlot] = ParticleInstance{ c.x, c.y, c.z, 1.0f - particles.elapsed * 10.0f, 0xffffffffu, 0.0f };
+    }
+    if (!persistent) glUnmapBuffer(GL_ARRAY_BUFFER);
+
+    // Les attributs pointent sur le segment courant
+    SUPERNOVA_PROFILE_SCOPE("draw");
+    glBindVertexArray(vertexArray);
+    const std::size_t base = first * sizeof(ParticleInstance);
+    const GLsizei stride = sizeof(ParticleInstance);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(base));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          reinterpret_cast<const void*>(base + offsetof(ParticleInstance, color)));
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const void*>(base + offsetof(ParticleInstance, density)));
+
+    // En SPH, la taille suit la densité locale plutôt que la distance au centre
+    const bool byDensity = particles.densityReference > 0.0f && particles.density != nullptr;
+
+    glUseProgram(program);
+    glUniformMatrix4fv(viewLocation, 1, GL_FALSE, &view[0][0]);
+    glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, &projection[0][0]);
+    glUniform3f(centerLocation, particles.center.x, particles.center.y, particles.center.z);
+    glUniform1f(densityReferenceLocation, byDensity ? particles.densityReference : 0.0f);
+    glUniform1i(flashInstanceLocation, flash ? GLint(flashSlot) : -1);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GLsizei(total));
+
+    fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    segment = (segment + 1) % ringSegments;
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+}
@@ -0,0 +1,60 @@
+// src/particle_store.cpp
+#include "particle_store.h"
+#include <algorithm>
+
+ParticleStore::ParticleStore(std::size_t capacity)
+    : maxCount(capacity)
+{
+    // Round up to a whole AVX register so kernels never read past the allocation
+    std::size_t padded = (capacity + 7) & ~std::size_t(7);
+    for (AlignedBuffer<float>* s : {&x, &y, &z, &vx, &vy, &vz, &r, &g, &b, &life, &density, &px, &py, &pz}) {
+        s->allocate(padded);
+    }
+}
+
+void ParticleStore::push(const Particle& p) {
+    if (count >= maxCount) return;
+    set(count++, p);
+}
+
+std::size_t ParticleStore::append(std::size_t n) {
+    std::size_t first = count;
+    count += std::min(n, maxCount - count);
+    return first;
+}
+
+void ParticleStore::set(std::size_t i, const Particle& p) {
+    x[i] = p.position.x;  y[i] = p.position.y;  z[i] = p.position.z;
+    vx[i] = p.velocity.x; vy[i] = p.velocity.y; vz[i] = p.velocity.z;
+    r[i] = p.color.r;     g[i] = p.color.g;     b[i] = p.color.b;
+    life[i] = p.life;
+    density[i] = p.density;
+    px[i] = p.position.x; py[i] = p.position.y; pz[i] = p.position.z; // pas encore d'historique
+}
+
+Particle ParticleStore::get(std::size_t i) const {
+    Particle p;
+    p.position = glm::vec3(x[i], y[i], z[i]);
+    p.velocity = glm::vec3(vx[i], vy[i], vz[i]);
+    p.color = glm::vec3(r[i], g[i], b[i]);
+    p.life = life[i];
+    p.density = density[i];
+    return p;
+}
+
+void ParticleStore::kill(std::size_t i) {
+    std::size_t last = --count;
+    if (i == last) return;
+    x[i] = x[last];   y[i] = y[last];   z[i] = z[last];
+    vx[i] = vx[last]; vy[i] = vy[last]; vz[i] = vz[last];
+    r[i] = r[last];   g[i] = g[last];   b[i] = b[last];
+    life[i] = life[last];
+    density[i] = density[last];
+    px[i] = px[last]; py[i] = py[last]; pz[i] = pz[last];
+}
+
+void ParticleStore::markPrevious(std::size_t begin, std::size_t end) {
+    std::copy(x.data() + begin, x.data() + end, px.data() + begin);
+    std::copy(y.data() + begin, y.data() + end, py.data() + begin);
+    std::copy(z.data() + begin, z.data() + end, pz.data() + begin);
+}
@@ -0,0 +1,289 @@
+// src/profiler.cpp
+// Profileur par frame : anneaux par thread, totaux par frame, exports trace et CSV
+#include "profiler.h"
+
+#if defined(SUPERNOVA_PROFILE) && SUPERNOVA_PROFILE
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    int64_t start;
+    int64_t end;
+    uint16_t id;
+};
+
+// Anneau mono-producteur : seul le thread propriétaire écrit, endFrame() lit
+struct ThreadRing {
+    uint32_t tid = 0;
+    std::atomic<bool> owned{true};           // false une fois son thread terminé
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    Event events[Profiler::ringSize];
+};
+
+struct TraceEvent {
+    int64_t start;
+    int64_t end;
+    uint32_t tid;
+    uint16_t id;
+};
+
+struct FrameRecord {
+    int64_t start = 0;
+    int64_t end = 0;
+    double scopeMs[Profiler::maxNames] = {};
+    int64_t counters[Profiler::maxCounters] = {};
+};
+
+struct State {
+    std::mutex mutex;                        // enregistrements, fin de frame, exports
+    const char* names[Profiler::maxNames] = {};
+    std::atomic<int> nameCount{0};
+    const char* counterNames[Profiler::maxCounters] = {};
+    std::atomic<bool> counterIsValue[Profiler::maxCounters] = {};
+    std::atomic<int> counterCount{0};
+    std::atomic<int64_t> counterValues[Profiler::maxCounters] = {};
+
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    std::vector<TraceEvent> trace;
+    std::vector<FrameRecord> frames;
+    std::atomic<uint64_t> dropped{0};
+    uint64_t traceDropped = 0;
+    int64_t epoch = Profiler::nowNs();
+    int64_t frameStart = epoch;
+};
+
+State& state() {
+    static State s;
+    return s;
+}
+
+// Rend l'anneau à la fin du thread : les pools redimensionnés ne l'accumulent pas
+struct LocalRing {
+    ThreadRing* ring = nullptr;
+    ~LocalRing() {
+        if (ring) ring->owned.store(false, std::memory_order_release);
+    }
+};
+
+thread_local LocalRing localRing;
+
+ThreadRing* ring() {
+    if (!localRing.ring) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        // Anneau d'un thread terminé et déjà vidé par endFrame() : sa piste est réutilisée
+        for (const std::unique_ptr<ThreadRing>& r : s.rings) {
+            if (!r->owned.load(std::memory_order_acquire) &&
+                r->head.load(std::memory_order_acquire) == r->tail.load(std::memory_order_relaxed)) {
+                r->owned.store(true, std::memory_order_relaxed);
+                localRing.ring = r.get();
+                break;
+            }
+        }
+        if (!localRing.ring) {
+            s.rings.push_back(std::make_unique<ThreadRing>());
+            localRing.ring = s.rings.back().get();
+            localRing.ring->tid = uint32_t(s.rings.size());
+        }
+    }
+    return localRing.ring;
+}
+
+uint16_t registerName(const char** table, std::atomic<int>& count, int capacity, const char* name) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    int n = count.load();
+    for (int i = 0; i < n; ++i) {
+        if (table[i] == name || std::strcmp(table[i], name) == 0) {
+            return uint16_t(i);
+        }
+    }
+    if (n == capacity) return uint16_t(capacity - 1); // table pleine : regroupé sur la dernière entrée
+    table[n] = name;
+    count.store(n + 1);
+    return uint16_t(n);
+}
+
+double percentile(std::vector<double>& values, double p) {
+    std::sort(values.begin(), values.end());
+    std::size_t rank = std::size_t(p * double(values.size() - 1) + 0.5);
+    return values[std::min(rank, values.size() - 1)];
+}
+
+void writeJsonString(std::FILE* f, const char* text) {
+    std::fputc('"', f);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') std::fputc('\\', f);
+        std::fputc(*c, f);
+    }
+    std::fputc('"', f);
+}
+
+} // namespace
+
+uint16_t Profiler::scopeId(const char* name) {
+    return registerName(state().names, state().nameCount, maxNames, name);
+}
+
+uint16_t Profiler::counterId(const char* name) {
+    return registerName(state().counterNames, state().counterCount, maxCounters, name);
+}
+
+void Profiler::record(uint16_t id, int64_t startNs, int64_t endNs) {
+    ThreadRing* r = ring();
+    uint64_t h = r->head.load(std::memory_order_relaxed);
+    if (h - r->tail.load(std::memory_order_acquire) == ringSize) {
+        state().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    r->events[h & (ringSize - 1)] = Event{startNs, endNs, id};
+    r->head.store(h + 1, std::memory_order_release);
+}
+
+void Profiler::count(uint16_t id, int64_t delta) {
+    state().counterValues[id].fetch_add(delta, std::memory_order_relaxed);
+}
+
+void Profiler::value(uint16_t id, int64_t v) {
+    State& s = state();
+    s.counterIsValue[id].store(true, std::memory_order_relaxed);
+    s.counterValues[id].store(v, std::memory_order_relaxed);
+}
+
+void Profiler::registerThread() {
+    ring();
+}
+
+void Profiler::endFrame() {
+    ring();  // le thread qui ferme les frames a son anneau avant la première mesure
+    State& s = state();
+    const int64_t now = nowNs();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    FrameRecord frame;
+    frame.start = s.frameStart;
+    frame.end = now;
+    for (const std::unique_ptr<ThreadRing>& r : s.rings) {
+        uint64_t t = r->tail.load(std::memory_order_relaxed);
+        const uint64_t h = r->head.load(std::memory_order_acquire);
+        for (; t < h; ++t) {
+            const Event& e = r->events[t & (ringSize - 1)];
+            frame.scopeMs[e.id] += double(e.end - e.start) * 1e-6;
+            if (s.trace.size() < maxTraceEvents) s.trace.push_back(TraceEvent{e.start, e.end, r->tid, e.id});
+            else ++s.traceDropped;
+        }
+        r->tail.store(h, std::memory_order_release);
+    }
+
+    // Compteurs cumulés remis à zéro, valeurs conservées d'une frame à l'autre
+    const int counters = s.counterCount.load();
+    for (int c = 0; c < counters; ++c) {
+        frame.counters[c] = s.counterIsValue[c] ? s.counterValues[c].load(std::memory_order_relaxed)
+                                                : s.counterValues[c].exchange(0, std::memory_order_relaxed);
+    }
+    s.frames.push_back(frame);
+    s.frameStart = now;
+}
+
+bool Profiler::writeChromeTrace(const char* path) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const TraceEvent& e : s.trace) {
+        std::fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+        writeJsonString(f, s.names[e.id]);
+        std::fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     e.tid, double(e.start - s.epoch) * 1e-3, double(e.end - e.start) * 1e-3);
+        first = false;
+    }
+    const int counters = s.counterCount.load();
+    for (const FrameRecord& frame : s.frames) {
+        for (int c = 0; c < counters; ++c) {
+            std::fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+            writeJsonString(f, s.counterNames[c]);
+            std::fprintf(f, ",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                         double(frame.end - s.epoch) * 1e-3, (long long)frame.counters[c]);
+            first = false;
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+    return std::fclose(f) == 0;
+}
+
+bool Profiler::writeCsv(const char* path) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+
+    const int names = s.nameCount.load();
+    const int counters = s.counterCount.load();
+    std::fprintf(f, "frame,start_ms,frame_ms");
+    for (int i = 0; i < names; ++i) std::fprintf(f, ",%s_ms", s.names[i]);
+    for (int c = 0; c < counters; ++c) std::fprintf(f, ",%s", s.counterNames[c]);
+    std::fprintf(f, "\n");
+
+    for (std::size_t n = 0; n < s.frames.size(); ++n) {
+        const FrameRecord& frame = s.frames[n];
+        std::fprintf(f, "%zu,%.3f,%.3f", n, double(frame.start - s.epoch) * 1e-6, double(frame.end - frame.start) * 1e-6);
+        for (int i = 0; i < names; ++i) std::fprintf(f, ",%.4f", frame.scopeMs[i]);
+        for (int c = 0; c < counters; ++c) std::fprintf(f, ",%lld", (long long)frame.counters[c]);
+        std::fprintf(f, "\n");
+    }
+    return std::fclose(f) == 0;
+}
+
+void Profiler::printSummary(std::FILE* out) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.frames.empty()) return;
+
+    std::fprintf(out, "profile: %zu frames, %llu scopes dropped (full ring), %llu beyond the trace limit\n",
+                 s.frames.size(), (unsigned long long)s.dropped.load(), (unsigned long long)s.traceDropped);
+    std::fprintf(out, "%-24s %8s %10s %10s %10s\n", "scope (ms per frame)", "frames", "min", "p50", "p99");
+
+    std::vector<double> values;
+    values.reserve(s.frames.size());
+    for (const FrameRecord& frame : s.frames) values.push_back(double(frame.end - frame.start) * 1e-6);
+    double lo = *std::min_element(values.begin(), values.end());
+    double p50 = percentile(values, 0.50), p99 = percentile(values, 0.99);
+    std::fprintf(out, "%-24s %8zu %10.3f %10.3f %10.3f\n", "frame", values.size(), lo, p50, p99);
+
+    const int names = s.nameCount.load();
+    for (int i = 0; i < names; ++i) {
+        values.clear();
+        for (const FrameRecord& frame : s.frames) {
+            if (frame.scopeMs[i] > 0.0) values.push_back(frame.scopeMs[i]);  // frames où la phase a tourné
+        }
+        if (values.empty()) continue;
+        lo = *std::min_element(values.begin(), values.end());
+        p50 = percentile(values, 0.50);
+        p99 = percentile(values, 0.99);
+        std::fprintf(out, "%-24s %8zu %10.3f %10.3f %10.3f\n", s.names[i], values.size(), lo, p50, p99);
+    }
+
+    const int counters = s.counterCount.load();
+    if (counters > 0) std::fprintf(out, "%-24s %8s %10s %10s %10s\n", "counter (per frame)", "frames", "min", "p50", "p99");
+    for (int c = 0; c < counters; ++c) {
+        values.clear();
+        for (const FrameRecord& frame : s.frames) values.push_back(double(frame.counters[c]));
+        lo = *std::min_element(values.begin(), values.end());
+        p50 = percentile(values, 0.50);
+        p99 = percentile(values, 0.99);
+        std::fprintf(out, "%-24s %8zu %10.0f %10.0f %10.0f\n", s.counterNames[c], values.size(), lo, p50, p99);
+    }
+}
+
+#endif
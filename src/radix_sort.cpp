@@ -0,0 +1,81 @@
+// src/radix_sort.cpp
+#include "radix_sort.h"
+#include <algorithm>
+#include <cstring>
+
+void RadixSorter::reserve(std::size_t count) {
+    if (keyScratch.size() < count) {
+        keyScratch.resize(count);
+        valueScratch.resize(count);
+    }
+    const std::size_t blocks = (count + blockSize - 1) / blockSize;
+    if (offsets.size() < blocks * 256) offsets.resize(blocks * 256);
+}
+
+void RadixSorter::sort(uint32_t* keys, uint32_t* values, std::size_t count, unsigned keyBits,
+                       ThreadPool& pool) {
+    if (count < 2) return;
+    reserve(count);
+    const std::size_t blocks = (count + blockSize - 1) / blockSize;
+
+    uint32_t* srcKeys = keys;
+    uint32_t* srcValues = values;
+    uint32_t* dstKeys = keyScratch.data();
+    uint32_t* dstValues = valueScratch.data();
+
+    for (unsigned shift = 0; shift < keyBits; shift += 8) {
+        // --- Histogramme par bloc ---
+        pool.parallelFor(blocks, 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t blk = first; blk < last; ++blk) {
+                uint32_t* hist = offsets.data() + blk * 256;
+                std::fill(hist, hist + 256, 0u);
+                std::size_t end = std::min((blk + 1) * blockSize, count);
+                for (std::size_t i = blk * blockSize; i < end; ++i) {
+                    ++hist[(srcKeys[i] >> shift) & 0xFF];
+                }
+            }
+        });
+
+        // Un seul chiffre présent : la passe ne changerait rien
+        bool trivial = false;
+        for (unsigned d = 0; d < 256; ++d) {
+            uint32_t total = 0;
+            for (std::size_t blk = 0; blk < blocks; ++blk) total += offsets[blk * 256 + d];
+            if (total == count) { trivial = true; break; }
+            if (total != 0) break;
+        }
+        if (trivial) continue;
+
+        // --- Décalages : chiffre d'abord, puis bloc (tri stable) ---
+        uint32_t running = 0;
+        for (unsigned d = 0; d < 256; ++d) {
+            for (std::size_t blk = 0; blk < blocks; ++blk) {
+                uint32_t n = offsets[blk * 256 + d];
+                offsets[blk * 256 + d] = running;
+                running += n;
+            }
+        }
+
+        // --- Dispersion ---
+        pool.parallelFor(blocks, 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t blk = first; blk < last; ++blk) {
+                uint32_t* offs = offsets.data() + blk * 256;
+                std::size_t end = std::min((blk + 1) * blockSize, count);
+                for (std::size_t i = blk * blockSize; i < end; ++i) {
+                    uint32_t k = srcKeys[i];
+                    uint32_t o = offs[(k >> shift) & 0xFF]++;
+                    dstKeys[o] = k;
+                    dstValues[o] = srcValues[i];
+                }
+            }
+        });
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    if (srcKeys != keys) {
+        std::memcpy(keys, srcKeys, count * sizeof(uint32_t));
+        std::memcpy(values, srcValues, count * sizeof(uint32_t));
+    }
+}
@@ -0,0 +1,161 @@
+// src/simulation_thread.cpp
+// Simulation à pas fixe sur son propre thread, snapshots en triple buffer
+#include "simulation_thread.h"
+#include "snapshot.h"
+#include "profiler.h"
+#include <algorithm>
+
+SimulationThread::SimulationThread(ParticleSystem& system, const SimulationSettings& settings)
+    : system(system), settings(settings)
+{
+    const std::size_t capacity = system.store().capacity();
+    for (Snapshot& s : buffers) {
+        for (AlignedBuffer<float>* stream : {&s.x, &s.y, &s.z, &s.vx, &s.vy, &s.vz, &s.r, &s.g, &s.b,
+                                             &s.life, &s.density, &s.px, &s.py, &s.pz}) {
+            stream->allocate(capacity);
+        }
+    }
+    ix.allocate(capacity);
+    iy.allocate(capacity);
+    iz.allocate(capacity);
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start(SnapshotWriter* writer) {
+    stop();
+    recorder = writer;
+    stopping = false;
+    published = 0;
+    dropped = 0;
+    epoch = std::chrono::steady_clock::now();
+
+    // État initial publié tout de suite : frame() a toujours quelque chose à lire
+    system.markPrevious();
+    publish(0.0);
+
+    finished.store(false, std::memory_order_release);
+    started = false;
+    worker = std::thread([this] { run(); });
+
+    // Le thread a son anneau de profilage avant que l'appelant ne mesure quoi que ce soit
+    std::unique_lock<std::mutex> lock(mutex);
+    startedCv.wait(lock, [this] { return started; });
+}
+
+void SimulationThread::stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    stopCv.notify_all();
+    worker.join();
+}
+
+double SimulationThread::now() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void SimulationThread::run() {
+    SUPERNOVA_PROFILE_THREAD();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        started = true;
+    }
+    startedCv.notify_one();
+    const double step = interval();
+    double next = step;                      // heure où le prochain snapshot est dû
+    uint64_t simulated = 0;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (settings.realTime) {
+            double t = now();
+            if (t < next) {
+                std::unique_lock<std::mutex> lock(mutex);
+                stopCv.wait_for(lock, std::chrono::duration<double>(next - t),
+                                [this] { return stopping.load(std::memory_order_relaxed); });
+                continue;
+            }
+        }
+
+        // Rattrapage borné ; au-delà, le temps de retard est abandonné
+        unsigned int caught = 0;
+        bool limitReached = false;
+        do {
+            system.markPrevious();
+            for (unsigned int s = 0; s < settings.substeps; ++s) system.update(settings.fixedStep);
+            publish(next);
+            next += step;
+            ++caught;
+            limitReached = settings.maxSnapshots != 0 && ++simulated >= settings.maxSnapshots;
+        } while (settings.realTime && !limitReached && caught < settings.maxCatchUp && now() >= next);
+
+        if (limitReached) break;
+        if (settings.realTime && now() >= next) {
+            uint64_t skipped = uint64_t((now() - next) / step) + 1;
+            dropped.fetch_add(skipped, std::memory_order_relaxed);
+            next += double(skipped) * step;
+        }
+    }
+    finished.store(true, std::memory_order_release);
+}
+
+void SimulationThread::publish(double time) {
+    SUPERNOVA_PROFILE_SCOPE("publish");
+    Snapshot& s = buffers[back];
+    const ParticleStore& store = system.store();
+    const std::size_t n = store.size();
+
+    const AlignedBuffer<float>* from[] = {&store.x, &store.y, &store.z, &store.vx, &store.vy, &store.vz,
+                                          &store.r, &store.g, &store.b, &store.life, &store.density,
+                                          &store.px, &store.py, &store.pz};
+    AlignedBuffer<float>* to[] = {&s.x, &s.y, &s.z, &s.vx, &s.vy, &s.vz, &s.r, &s.g, &s.b,
+                                  &s.life, &s.density, &s.px, &s.py, &s.pz};
+    for (int k = 0; k < 14; ++k) std::copy(from[k]->data(), from[k]->data() + n, to[k]->data());
+
+    const ParticleView live = system.view();
+    s.count = n;
+    s.time = time;
+    s.elapsed = live.elapsed;
+    s.center = live.center;
+    s.densityReference = live.densityReference;
+
+    if (recorder) recorder->submit(live);
+
+    // Publication : le buffer plein devient `ready`, l'ancien `ready` devient le nouveau back
+    back = ready.exchange(back | freshBit, std::memory_order_acq_rel) & 3u;
+    published.fetch_add(1, std::memory_order_relaxed);
+}
+
+ParticleView SimulationThread::frame() {
+    if (ready.load(std::memory_order_acquire) & freshBit) {
+        front = ready.exchange(front, std::memory_order_acq_rel) & 3u;
+    }
+    const Snapshot& s = buffers[front];
+
+    // Le rendu a un intervalle de retard : alpha = 0 au moment où le snapshot est dû
+    float alpha = 1.0f;
+    if (settings.realTime) {
+        alpha = std::clamp(float((now() - s.time) / interval()), 0.0f, 1.0f);
+    }
+    for (std::size_t i = 0; i < s.count; ++i) {
+        ix[i] = s.px[i] + (s.x[i] - s.px[i]) * alpha;
+        iy[i] = s.py[i] + (s.y[i] - s.py[i]) * alpha;
+        iz[i] = s.pz[i] + (s.z[i] - s.pz[i]) * alpha;
+    }
+
+    ParticleView v;
+    v.count = s.count;
+    v.x = ix.data();     v.y = iy.data();     v.z = iz.data();
+    v.vx = s.vx.data();  v.vy = s.vy.data();  v.vz = s.vz.data();
+    v.r = s.r.data();    v.g = s.g.data();    v.b = s.b.data();
+    v.life = s.life.data();
+    v.density = s.density.data();
+    v.center = s.center;
+    v.elapsed = s.elapsed;
+    v.densityReference = s.densityReference;
+    return v;
+}
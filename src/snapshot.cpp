@@ -0,0 +1,434 @@
+// src/snapshot.cpp
+// Enregistrement binaire des frames (thread d'écriture) et relecture par mmap
+#include "snapshot.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char fileMagic[8] = {'S', 'N', 'O', 'V', 'A', 'S', 'N', 'P'};
+constexpr uint32_t frameMagic = 0x454d5246u; // "FRME"
+constexpr int quantizedStreams = 7;          // x y z vx vy vz life
+
+inline std::size_t padded(std::size_t bytes) { return (bytes + 63) & ~std::size_t(63); }
+
+// Bytes per value of stream s (x y z vx vy vz r g b life density)
+inline std::size_t valueSize(SnapshotEncoding encoding, int s) {
+    if (encoding == SnapshotEncoding::Raw) return 4;
+    if (s < 6 || s == 9) return 2;
+    if (s < 9) return 1;
+    return 4;
+}
+
+inline std::size_t frameBytes(SnapshotEncoding encoding, std::size_t count) {
+    std::size_t bytes = sizeof(SnapshotFrameHeader);
+    for (int s = 0; s < 11; ++s) bytes += padded(valueSize(encoding, s) * count);
+    return bytes;
+}
+
+// Streams 0-5 and 9 are quantized against per-frame bounds, in this order
+inline int quantizedSlot(int s) { return s < 6 ? s : 6; }
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// SnapshotWriter
+// ---------------------------------------------------------------------------
+
+SnapshotWriter::SnapshotWriter(std::size_t capacity, SnapshotEncoding encoding)
+    : capacity(capacity), encoding(encoding)
+{
+    for (Slot& slot : slots) slot.data.allocate(streamCount * capacity);
+    if (encoding == SnapshotEncoding::Quantized) {
+        encoded.allocate(frameBytes(encoding, capacity) - sizeof(SnapshotFrameHeader));
+    }
+    index.reserve(4096);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    close();
+}
+
+bool SnapshotWriter::open(const char* path) {
+    if (file) return false;
+    file = std::fopen(path, "wb");
+    if (!file) return false;
+
+    ioError = false;
+    closing = false;
+    nextSlot = 0;
+    frames = 0;
+    offset = 0;
+    bytes = 0;
+    stallCount = 0;
+    index.clear();
+
+    // En-tête valide dès l'ouverture, sans index : un enregistrement interrompu
+    // se relit en parcourant les frames. close() n'y réécrit que l'index.
+    SnapshotFileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = snapshotVersion;
+    header.encoding = uint32_t(encoding);
+    header.capacity = capacity;
+    writeBytes(&header, sizeof(header));
+
+    writerStarted = false;
+    writer = std::thread([this] { writerLoop(); });
+
+    // Le thread d'écriture a son anneau de profilage avant la première frame
+    std::unique_lock<std::mutex> lock(mutex);
+    freedCv.wait(lock, [this] { return writerStarted; });
+    return true;
+}
+
+void SnapshotWriter::submit(const ParticleView& frame) {
+    if (!file) return;
+    SUPERNOVA_PROFILE_SCOPE("record submit");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    Slot& slot = slots[nextSlot];
+    if (slot.queued) {
+        ++stallCount;                        // le disque a deux frames de retard
+        SUPERNOVA_PROFILE_COUNT("record stalls", 1);
+        freedCv.wait(lock, [&] { return !slot.queued; });
+    }
+    lock.unlock();
+
+    // Copie seule sur le thread de simulation ; l'encodage se fait à l'écriture
+    const std::size_t n = std::min(frame.count, capacity);
+    const float* streams[streamCount] = { frame.x, frame.y, frame.z, frame.vx, frame.vy, frame.vz,
+                                          frame.r, frame.g, frame.b, frame.life, frame.density };
+    for (int s = 0; s < streamCount; ++s) {
+        float* out = slot.data.data() + s * capacity;
+        if (streams[s]) std::memcpy(out, streams[s], n * sizeof(float));
+        else std::fill(out, out + n, 0.0f);
+    }
+
+    SnapshotFrameHeader& h = slot.header;
+    h = SnapshotFrameHeader{};
+    h.magic = frameMagic;
+    h.encoding = uint32_t(encoding);
+    h.count = n;
+    h.byteSize = frameBytes(encoding, n);
+    h.elapsed = frame.elapsed;
+    h.centerX = frame.center.x;
+    h.centerY = frame.center.y;
+    h.centerZ = frame.center.z;
+    h.densityReference = frame.densityReference;
+
+    lock.lock();
+    slot.queued = true;
+    nextSlot ^= 1;
+    queuedCv.notify_one();
+}
+
+bool SnapshotWriter::close() {
+    if (!file) return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    queuedCv.notify_one();
+    writer.join();
+
+    // Index des frames en fin de fichier, puis frameCount et indexOffset dans l'en-tête
+    const uint64_t indexFields[2] = { index.size(), offset };
+    writeBytes(index.data(), index.size() * sizeof(uint64_t));
+
+    static_assert(offsetof(SnapshotFileHeader, indexOffset) ==
+                  offsetof(SnapshotFileHeader, frameCount) + sizeof(uint64_t), "index fields are contiguous");
+    if (std::fseek(file, long(offsetof(SnapshotFileHeader, frameCount)), SEEK_SET) != 0 ||
+        std::fwrite(indexFields, sizeof(indexFields), 1, file) != 1) {
+        ioError = true;
+    }
+    if (std::fclose(file) != 0) ioError = true;
+    file = nullptr;
+    return !ioError;
+}
+
+uint64_t SnapshotWriter::framesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return frames;
+}
+
+uint64_t SnapshotWriter::bytesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+uint64_t SnapshotWriter::stalls() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stallCount;
+}
+
+// Les slots sont remplis et écrits en alternance : l'ordre des frames est conservé
+void SnapshotWriter::writerLoop() {
+    SUPERNOVA_PROFILE_THREAD();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        writerStarted = true;
+    }
+    freedCv.notify_all();
+    int current = 0;
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex);
+        queuedCv.wait(lock, [&] { return slots[current].queued || closing; });
+        if (!slots[current].queued) return;  // fermeture, plus rien en attente
+        lock.unlock();
+
+        {
+            SUPERNOVA_PROFILE_SCOPE("record write");
+            writeFrame(slots[current]);
+        }
+
+        lock.lock();
+        slots[current].queued = false;
+        ++frames;
+        bytes = offset;
+        freedCv.notify_one();
+        current ^= 1;
+    }
+}
+
+void SnapshotWriter::writeFrame(Slot& slot) {
+    SnapshotFrameHeader& h = slot.header;
+    const std::size_t n = std::size_t(h.count);
+    index.push_back(offset);
+
+    if (encoding == SnapshotEncoding::Raw) {
+        writeBytes(&h, sizeof(h));
+        for (int s = 0; s < streamCount; ++s) {
+            writeBytes(slot.data.data() + s * capacity, n * sizeof(float));
+            writePadding(padded(n * sizeof(float)) - n * sizeof(float));
+        }
+        return;
+    }
+
+    // --- Quantification : bornes par frame, 16 bits par valeur ---
+    const int quantized[quantizedStreams] = {0, 1, 2, 3, 4, 5, 9};
+    float inv[quantizedStreams];
+    for (int q = 0; q < quantizedStreams; ++q) {
+        const float* v = slot.data.data() + quantized[q] * capacity;
+        float lo = 0.0f, hi = 0.0f;
+        if (n > 0) {
+            auto [mn, mx] = std::minmax_element(v, v + n);
+            lo = *mn;
+            hi = *mx;
+        }
+        h.lo[q] = lo;
+        h.step[q] = (hi - lo) / 65535.0f;
+        inv[q] = h.step[q] > 0.0f ? 1.0f / h.step[q] : 0.0f;
+    }
+
+    unsigned char* out = encoded.data();
+    for (int s = 0; s < streamCount; ++s) {
+        const float* v = slot.data.data() + s * capacity;
+        const std::size_t size = valueSize(encoding, s) * n;
+        if (s < 6 || s == 9) {
+            const int q = quantizedSlot(s);
+            uint16_t* dst = reinterpret_cast<uint16_t*>(out);
+            for (std::size_t i = 0; i < n; ++i) {
+                dst[i] = uint16_t(std::min((v[i] - h.lo[q]) * inv[q] + 0.5f, 65535.0f));
+            }
+        } else if (s < 9) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = uint8_t(std::clamp(v[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        } else {
+            std::memcpy(out, v, size);
+        }
+        std::memset(out + size, 0, padded(size) - size);
+        out += padded(size);
+    }
+
+    writeBytes(&h, sizeof(h));
+    writeBytes(encoded.data(), std::size_t(out - encoded.data()));
+}
+
+void SnapshotWriter::writeBytes(const void* data, std::size_t size) {
+    if (size == 0) return;
+    if (std::fwrite(data, 1, size, file) != size) ioError = true;
+    offset += size;
+}
+
+void SnapshotWriter::writePadding(std::size_t size) {
+    static const unsigned char zeros[64] = {};
+    writeBytes(zeros, size);
+}
+
+// ---------------------------------------------------------------------------
+// SnapshotReader
+// ---------------------------------------------------------------------------
+
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+bool SnapshotReader::open(const char* path) {
+    close();
+
+#if defined(_WIN32)
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size) || size.QuadPart < LONGLONG(sizeof(SnapshotFileHeader))) {
+        CloseHandle(f);
+        return false;
+    }
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = m ? MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (m) CloseHandle(m);
+        CloseHandle(f);
+        return false;
+    }
+    fileHandle = f;
+    mappingHandle = m;
+    length = std::size_t(size.QuadPart);
+    base = static_cast<const unsigned char*>(view);
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(SnapshotFileHeader))) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);                             // la projection reste valide
+    if (view == MAP_FAILED) return false;
+    length = std::size_t(st.st_size);
+    base = static_cast<const unsigned char*>(view);
+#endif
+
+    const SnapshotFileHeader& file = *reinterpret_cast<const SnapshotFileHeader*>(base);
+    if (std::memcmp(file.magic, fileMagic, sizeof(fileMagic)) != 0 || file.version != snapshotVersion ||
+        file.encoding > uint32_t(SnapshotEncoding::Quantized)) {
+        close();
+        return false;
+    }
+    fileEncoding = SnapshotEncoding(file.encoding);
+
+    // Index en fin de fichier, ou parcours des frames si l'enregistrement a été interrompu
+    if (file.indexOffset != 0 && file.indexOffset <= length &&
+        file.frameCount <= (length - file.indexOffset) / sizeof(uint64_t)) {
+        offsets = reinterpret_cast<const uint64_t*>(base + file.indexOffset);
+        frames = std::size_t(file.frameCount);
+    } else {
+        std::size_t pos = sizeof(SnapshotFileHeader);
+        while (pos + sizeof(SnapshotFrameHeader) <= length) {
+            const SnapshotFrameHeader& h = *reinterpret_cast<const SnapshotFrameHeader*>(base + pos);
+            if (h.magic != frameMagic || h.byteSize < sizeof(SnapshotFrameHeader) || h.byteSize > length - pos) break;
+            scanned.push_back(pos);
+            pos += std::size_t(h.byteSize);
+        }
+        offsets = scanned.data();
+        frames = scanned.size();
+    }
+
+    // Chaque frame doit tenir dans le fichier avec ses flux
+    maxCount = 0;
+    for (std::size_t i = 0; i < frames; ++i) {
+        uint64_t at = offsets[i];
+        if (at > length || length - at < sizeof(SnapshotFrameHeader)) { close(); return false; }
+        const SnapshotFrameHeader& h = header(i);
+        if (h.magic != frameMagic || h.encoding != file.encoding ||
+            h.byteSize != frameBytes(fileEncoding, std::size_t(h.count)) || h.byteSize > length - at) {
+            close();
+            return false;
+        }
+        maxCount = std::max(maxCount, std::size_t(h.count));
+    }
+    if (fileEncoding == SnapshotEncoding::Quantized) decoded.allocate(11 * maxCount);
+    return true;
+}
+
+void SnapshotReader::close() {
+    if (base) {
+#if defined(_WIN32)
+        UnmapViewOfFile(base);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<unsigned char*>(base), length);
+#endif
+    }
+    base = nullptr;
+    length = 0;
+    offsets = nullptr;
+    scanned.clear();
+    frames = 0;
+    maxCount = 0;
+}
+
+const SnapshotFrameHeader& SnapshotReader::header(std::size_t index) const {
+    return *reinterpret_cast<const SnapshotFrameHeader*>(base + offsets[index]);
+}
+
+float SnapshotReader::frameTime(std::size_t index) const {
+    return header(index).elapsed;
+}
+
+std::size_t SnapshotReader::seek(float elapsed) const {
+    std::size_t lo = 0, hi = frames;         // premier frame strictement après `elapsed`
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        if (frameTime(mid) <= elapsed) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo > 0 ? lo - 1 : 0;
+}
+
+ParticleView SnapshotReader::frame(std::size_t index) {
+    const SnapshotFrameHeader& h = header(index);
+    const std::size_t n = std::size_t(h.count);
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(&h) + sizeof(SnapshotFrameHeader);
+
+    const float* streams[11];
+    for (int s = 0; s < 11; ++s) {
+        const std::size_t size = valueSize(fileEncoding, s) * n;
+        if (fileEncoding == SnapshotEncoding::Raw) {
+            streams[s] = reinterpret_cast<const float*>(in); // sans copie
+        } else {
+            float* out = decoded.data() + s * maxCount;
+            if (s < 6 || s == 9) {
+                const int q = quantizedSlot(s);
+                const uint16_t* src = reinterpret_cast<const uint16_t*>(in);
+                for (std::size_t i = 0; i < n; ++i) out[i] = h.lo[q] + float(src[i]) * h.step[q];
+            } else if (s < 9) {
+                for (std::size_t i = 0; i < n; ++i) out[i] = float(in[i]) * (1.0f / 255.0f);
+            } else {
+                std::memcpy(out, in, size);
+            }
+            streams[s] = out;
+        }
+        in += padded(size);
+    }
+
+    ParticleView v;
+    v.count = n;
+    v.x = streams[0];  v.y = streams[1];  v.z = streams[2];
+    v.vx = streams[3]; v.vy = streams[4]; v.vz = streams[5];
+    v.r = streams[6];  v.g = streams[7];  v.b = streams[8];
+    v.life = streams[9];
+    v.density = streams[10];
+    v.center = glm::vec3(h.centerX, h.centerY, h.centerZ);
+    v.elapsed = h.elapsed;
+    v.densityReference = h.densityReference;
+    return v;
+}
@@ -0,0 +1,87 @@
+// src/spatial_grid.cpp
+// Grille de hachage spatiale pour la recherche de voisins
+#include "spatial_grid.h"
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(std::size_t capacity, float size)
+    : keys(capacity), sortedIndex(capacity), sx(capacity), sy(capacity), sz(capacity)
+{
+    setCellSize(size);
+
+    // Au moins autant de cases que de particules : peu de collisions
+    tableBits = 10;
+    while ((std::size_t(1) << tableBits) < capacity && tableBits < 30) ++tableBits;
+    tableMask = (1u << tableBits) - 1;
+
+    bucketStart.allocate((std::size_t(1) << tableBits) + 1);
+    std::fill(bucketStart.data(), bucketStart.data() + bucketStart.size(), 0u);
+    sorter.reserve(capacity);
+}
+
+void SpatialGrid::rebuild(const float* x, const float* y, const float* z, std::size_t n, ThreadPool& pool) {
+    count = std::min(n, keys.size());
+    const uint32_t tableSize = tableMask + 1;
+    if (count == 0) {
+        std::fill(bucketStart.data(), bucketStart.data() + bucketStart.size(), 0u);
+        return;
+    }
+
+    pool.parallelFor(count, 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            keys[i] = hashCell(cellCoord(x[i]), cellCoord(y[i]), cellCoord(z[i]));
+            sortedIndex[i] = uint32_t(i);
+        }
+    });
+    sorter.sort(keys.data(), sortedIndex.data(), count, tableBits, pool);
+
+    // Début de chaque case (table complète, cases vides comprises) + positions
+    // dans l'ordre des cases. Chaque k écrit les cases ]keys[k-1], keys[k]] :
+    // intervalles disjoints, aucune remise à zéro nécessaire.
+    pool.parallelFor(count, 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            uint32_t first = (k == 0) ? 0u : keys[k - 1] + 1;
+            for (uint32_t b = first; b <= keys[k]; ++b) {
+                bucketStart[b] = uint32_t(k);
+            }
+            uint32_t i = sortedIndex[k];
+            sx[k] = x[i]; sy[k] = y[i]; sz[k] = z[i];
+        }
+    });
+    std::fill(bucketStart.data() + keys[count - 1] + 1, bucketStart.data() + tableSize + 1, uint32_t(count));
+}
+
+int SpatialGrid::neighbourRanges(int ix, int iy, int iz, Range out[27]) const {
+    // Intervalles de cases [lo, hi) : une rangée de 3 cases consécutives, ou
+    // plusieurs morceaux si elle fait le tour de la table
+    uint32_t lo[27], hi[27];
+    int n = 0;
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            uint32_t first = hashCell(ix - 1, iy + dy, iz + dz);
+            if (first + 3 <= tableMask + 1) {
+                lo[n] = first; hi[n] = first + 3; ++n;
+            } else {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    uint32_t h = hashCell(ix + dx, iy + dy, iz + dz);
+                    lo[n] = h; hi[n] = h + 1; ++n;
+                }
+            }
+        }
+    }
+
+    // Tri par début puis fusion des chevauchements (rangées en collision)
+    for (int a = 1; a < n; ++a) {
+        uint32_t l = lo[a], h = hi[a];
+        int b = a;
+        for (; b > 0 && lo[b - 1] > l; --b) { lo[b] = lo[b - 1]; hi[b] = hi[b - 1]; }
+        lo[b] = l; hi[b] = h;
+    }
+    int ranges = 0;
+    for (int a = 0; a < n;) {
+        uint32_t l = lo[a], h = hi[a];
+        for (++a; a < n && lo[a] <= h; ++a) h = std::max(h, hi[a]);
+        Range r{ bucketStart[l], bucketStart[h] };
+        if (r.begin != r.end) out[ranges++] = r;
+    }
+    return ranges;
+}
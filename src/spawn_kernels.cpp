@@ -0,0 +1,427 @@
+// src/spawn_kernels.cpp
+// Génération des particules par lots (SoA) : SSE / scalaire.
+// Like the integration kernel, every path performs the same IEEE operations in
+// the same order (no FMA, exact sqrt and division, the same polynomial sincos),
+// so SIMD and scalar results are bit-identical.
+#include "spawn_kernels.h"
+#include "random.h"
+#include "shell_tiers.h"
+#include "sph.h"
+#include <cmath>
+
+#if !defined(SUPERNOVA_FORCE_SCALAR)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SUPERNOVA_SPAWN_SSE 1
+#    include <emmintrin.h>
+#  endif
+#endif
+
+namespace {
+
+struct Streams {
+    float* x; float* y; float* z;
+    float* vx; float* vy; float* vz;
+    float* r; float* g; float* b;
+    float* life; float* density;
+    float* px; float* py; float* pz;
+};
+
+Streams streamsOf(ParticleStore& s) {
+    return { s.x.data(), s.y.data(), s.z.data(),
+             s.vx.data(), s.vy.data(), s.vz.data(),
+             s.r.data(), s.g.data(), s.b.data(),
+             s.life.data(), s.density.data(),
+             s.px.data(), s.py.data(), s.pz.data() };
+}
+
+// sin et cos : réduction à [-pi/4, pi/4] (pi/2 en trois morceaux, Cody-Waite)
+// puis les polynômes de Cephes. Erreur ~1e-7 pour |x| < 1e4.
+constexpr float twoOverPi = 0.636619772f;
+constexpr float halfPiA = 1.5703125f;
+constexpr float halfPiB = 4.837512969970703125e-4f;
+constexpr float halfPiC = 7.54978995489188216e-8f;
+constexpr float sinC0 = -1.9515295891e-4f, sinC1 = 8.3321608736e-3f, sinC2 = -1.6666654611e-1f;
+constexpr float cosC0 = 2.443315711809948e-5f, cosC1 = -1.388731625493765e-3f, cosC2 = 4.166664568298827e-2f;
+
+// Même arrondi que _mm_cvtps_epi32 (au plus proche, pair)
+inline void sinCos(float x, float& s, float& c) {
+    const int quadrant = int(std::lrint(x * twoOverPi));
+    const float q = float(quadrant);
+    const float r = ((x - q * halfPiA) - q * halfPiB) - q * halfPiC;
+    const float z = r * r;
+    const float sr = ((sinC0 * z + sinC1) * z + sinC2) * z * r + r;
+    const float cr = ((((cosC0 * z + cosC1) * z + cosC2) * z) * z - 0.5f * z) + 1.0f;
+    s = (quadrant & 1) ? cr : sr;
+    c = (quadrant & 1) ? sr : cr;
+    if (quadrant & 2) s = -s;
+    if ((quadrant + 1) & 2) c = -c;
+}
+
+// Zone de la coquille ; en SPH, elle suit la densité du gaz au point
+// d'apparition (grille du pas précédent)
+inline int shellTier(float x, float y, float z, float dist, const SpawnParams& p, float& density) {
+    density = 0.0f;
+    if (p.sph && p.sph->meanDensity() > 0.0f) {
+        density = p.sph->sampleDensity(x, y, z);
+        return tierFromDensity(density, p.sph->meanDensity());
+    }
+    return tierFromDistance(dist);
+}
+
+void writeShellColor(const Streams& s, std::size_t i, float t, float dist, float dust,
+                     const EmitterSettings& e, const SpawnParams& p) {
+    float density;
+    const int tier = shellTier(s.x[i], s.y[i], s.z[i], dist, p, density);
+    const float u = 1.0f - t;
+    glm::vec3 color;
+    if (tier == 0) color = e.coreColor;
+    else if (tier == 1) color = e.innerColorA * u + e.innerColorB * t;
+    else if (tier == 2) color = e.midColorA * u + e.midColorB * t;
+    else color = e.outerColor;
+    if (dust < e.dustProbability) color = e.dustColor;
+
+    s.r[i] = color.r; s.g[i] = color.g; s.b[i] = color.b;
+    s.density[i] = density;
+}
+
+// --- Particule de la coquille ---
+// Les tirages viennent du flux du numéro de série, dans l'ordre : filament, t,
+// rayon, anneau, poussière, vitesse, durée de vie.
+void shellScalar(const Streams& s, std::size_t i, uint64_t serial,
+                 const EmitterSettings& e, const SpawnParams& p) {
+    CounterRng rng(p.seed, serial, 0, RngDomain::Spawn);
+    const uint32_t idx = rng.below(uint32_t(e.filaments));
+    const float t = rng.uniform();
+    const float uRadius = rng.uniform();
+    const float uRing = rng.uniform();
+    const float uDust = rng.uniform();
+    const float uSpeed = rng.uniform();
+    const float uLife = rng.uniform();
+
+    // Direction du filament, courbée le long de t
+    const float bx = p.filamentX[idx], by = p.filamentY[idx], bz = p.filamentZ[idx];
+    const float fi = float(idx);
+    const float bend = (t - 0.5f) * e.bend;
+    float dx = bx + by * bend;
+    float dy = by - bx * bend;
+    float dz = bz;
+    const float invLen = 1.0f / std::sqrt(dx * dx + dy * dy + dz * dz);
+    dx = dx * invLen; dy = dy * invLen; dz = dz * invLen;
+
+    // Forme ovoïde
+    const float radius = (e.radiusMin + t * e.radiusRange) + uRadius * e.radiusJitter;
+    float ox = dx * radius;
+    float oy = (dy * radius) * e.stretchY;
+    float oz = dz * radius;
+
+    // Vagues et arcs
+    float waveSin, waveCos, arcSin, arcCos, noiseSin, noiseCos;
+    sinCos(radius * e.waveFrequency + fi, waveSin, waveCos);
+    sinCos(fi + t * 6.28f, arcSin, arcCos);
+    sinCos((ox * 2.1f + oy * 1.3f) + oz * 0.7f, noiseSin, noiseCos);
+    const float wave = waveSin * e.waveAmplitude;
+    ox = ox + wave * arcCos;
+    oy = oy + noiseSin * e.noiseAmplitude;
+    oz = oz + wave * arcSin;
+
+    // Anneaux et boucles
+    if (uRing < e.ringProbability) {
+        float ringSin, ringCos, wobbleSin, wobbleCos;
+        sinCos(t * 6.28f, ringSin, ringCos);
+        sinCos(fi + t * 3.0f, wobbleSin, wobbleCos);
+        const float ringRadius = e.ringRadius + e.ringWobble * wobbleSin;
+        ox = ox + ringCos * ringRadius;
+        oz = oz + ringSin * ringRadius;
+    }
+
+    const float dist = std::sqrt(ox * ox + oy * oy + oz * oz);
+    const float speed = ((e.speedMin + t * e.speedRange) + uSpeed * e.speedJitter) * p.speedScale;
+    s.x[i] = s.px[i] = e.center.x + ox;
+    s.y[i] = s.py[i] = e.center.y + oy;
+    s.z[i] = s.pz[i] = e.center.z + oz;
+    s.vx[i] = dx * speed; s.vy[i] = dy * speed; s.vz[i] = dz * speed;
+    s.life[i] = (e.lifeMin + t * e.lifeRange) + uLife * e.lifeJitter;
+    writeShellColor(s, i, t, dist, uDust, e, p);
+}
+
+// --- Particule de l'onde de choc ---
+void shockScalar(const Streams& s, std::size_t i, uint64_t serial, const EmitterSettings& e, uint64_t seed) {
+    CounterRng rng(seed, serial, 0, RngDomain::Shock);
+    const float theta = (rng.uniform() * 2.0f) * 3.14159f;
+    const float phi = rng.uniform() * 3.14159f;
+    const float speed = e.shockSpeed + rng.uniform() * e.shockSpeedJitter;
+    float thetaSin, thetaCos, phiSin, phiCos;
+    sinCos(theta, thetaSin, thetaCos);
+    sinCos(phi, phiSin, phiCos);
+
+    s.x[i] = s.px[i] = e.center.x;
+    s.y[i] = s.py[i] = e.center.y;
+    s.z[i] = s.pz[i] = e.center.z;
+    s.vx[i] = (phiSin * thetaCos) * speed;
+    s.vy[i] = (phiSin * thetaSin) * speed;
+    s.vz[i] = phiCos * speed;
+    s.r[i] = e.shockColor.r; s.g[i] = e.shockColor.g; s.b[i] = e.shockColor.b;
+    s.life[i] = e.shockLife;
+    s.density[i] = 0.0f;
+}
+
+#if defined(SUPERNOVA_SPAWN_SSE)
+
+// Produits 32 x 32 -> 64 bits de chaque voie par m : moitiés basse et haute
+inline void mulWide(__m128i a, __m128i m, __m128i& lo, __m128i& hi) {
+    __m128i even = _mm_mul_epu32(a, m);                          // voies 0 et 2
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);       // voies 1 et 3
+    even = _mm_shuffle_epi32(even, _MM_SHUFFLE(3, 1, 2, 0));     // lo0 lo2 hi0 hi2
+    odd = _mm_shuffle_epi32(odd, _MM_SHUFFLE(3, 1, 2, 0));       // lo1 lo3 hi1 hi3
+    lo = _mm_unpacklo_epi32(even, odd);
+    hi = _mm_unpackhi_epi32(even, odd);
+}
+
+// Philox4x32-10 sur quatre compteurs à la fois (un par voie), même clé ;
+// les Blocks états avancent ensemble, tour par tour.
+template <int Blocks>
+inline void philox4(__m128i (&c)[Blocks][4], uint64_t seed) {
+    const __m128i m0 = _mm_set1_epi32(int(0xD2511F53u));
+    const __m128i m1 = _mm_set1_epi32(int(0xCD9E8D57u));
+    uint32_t k0 = uint32_t(seed), k1 = uint32_t(seed >> 32);
+    for (int round = 0; round < 10; ++round) {
+        const __m128i key0 = _mm_set1_epi32(int(k0)), key1 = _mm_set1_epi32(int(k1));
+        for (int b = 0; b < Blocks; ++b) {
+            __m128i lo0, hi0, lo1, hi1;
+            mulWide(c[b][0], m0, lo0, hi0);
+            mulWide(c[b][2], m1, lo1, hi1);
+            c[b][0] = _mm_xor_si128(_mm_xor_si128(hi1, c[b][1]), key0);
+            c[b][1] = lo1;
+            c[b][2] = _mm_xor_si128(_mm_xor_si128(hi0, c[b][3]), key1);
+            c[b][3] = lo0;
+        }
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+}
+
+// Blocs 0..Blocks-1 des flux (seed, serial + voie, 0, domain), comme CounterRng
+template <int Blocks>
+inline void philoxBlocks(__m128i (&out)[Blocks][4], uint64_t seed, uint64_t serial, RngDomain domain) {
+    const uint64_t s0 = serial, s1 = serial + 1, s2 = serial + 2, s3 = serial + 3;
+    for (int b = 0; b < Blocks; ++b) {
+        out[b][0] = _mm_setr_epi32(int(uint32_t(s0)), int(uint32_t(s1)), int(uint32_t(s2)), int(uint32_t(s3)));
+        out[b][1] = _mm_setr_epi32(int(uint32_t(s0 >> 32)), int(uint32_t(s1 >> 32)),
+                                   int(uint32_t(s2 >> 32)), int(uint32_t(s3 >> 32)));
+        out[b][2] = _mm_setzero_si128();
+        out[b][3] = _mm_set1_epi32(int((uint32_t(domain) << 24) + uint32_t(b)));
+    }
+    philox4(out, seed);
+}
+
+inline __m128 uniform4(__m128i bits) {
+    return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bits, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+}
+
+inline __m128 select4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+inline void sinCos4(__m128 x, __m128& s, __m128& c) {
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(twoOverPi)));
+    const __m128 q = _mm_cvtepi32_ps(quadrant);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(halfPiA)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(halfPiB)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(halfPiC)));
+    const __m128 z = _mm_mul_ps(r, r);
+
+    __m128 sr = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sinC0), z), _mm_set1_ps(sinC1));
+    sr = _mm_add_ps(_mm_mul_ps(sr, z), _mm_set1_ps(sinC2));
+    sr = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sr, z), r), r);
+    __m128 cr = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(cosC0), z), _mm_set1_ps(cosC1));
+    cr = _mm_add_ps(_mm_mul_ps(cr, z), _mm_set1_ps(cosC2));
+    cr = _mm_mul_ps(_mm_mul_ps(cr, z), z);
+    cr = _mm_add_ps(_mm_sub_ps(cr, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+    const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+    const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+    const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+    s = _mm_xor_ps(select4(swap, cr, sr), sinSign);
+    c = _mm_xor_ps(select4(swap, sr, cr), cosSign);
+}
+
+// Quatre particules de la coquille, slots [i, i + 4), mêmes calculs que shellScalar
+void shell4(const Streams& s, std::size_t i, uint64_t serial, const EmitterSettings& e, const SpawnParams& p) {
+    __m128i block[2][4];
+    philoxBlocks(block, p.seed, serial, RngDomain::Spawn);
+    const __m128i* block0 = block[0];
+    const __m128i* block1 = block[1];
+
+    // below(filaments) : moitié haute de bits * n
+    __m128i lo, idx;
+    mulWide(block0[0], _mm_set1_epi32(e.filaments), lo, idx);
+    const __m128 t = uniform4(block0[1]);
+    const __m128 uRadius = uniform4(block0[2]);
+    const __m128 uRing = uniform4(block0[3]);
+    const __m128 uDust = uniform4(block1[0]);
+    const __m128 uSpeed = uniform4(block1[1]);
+    const __m128 uLife = uniform4(block1[2]);
+
+    alignas(16) uint32_t lane[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lane), idx);
+    const __m128 bx = _mm_setr_ps(p.filamentX[lane[0]], p.filamentX[lane[1]], p.filamentX[lane[2]], p.filamentX[lane[3]]);
+    const __m128 by = _mm_setr_ps(p.filamentY[lane[0]], p.filamentY[lane[1]], p.filamentY[lane[2]], p.filamentY[lane[3]]);
+    const __m128 bz = _mm_setr_ps(p.filamentZ[lane[0]], p.filamentZ[lane[1]], p.filamentZ[lane[2]], p.filamentZ[lane[3]]);
+    const __m128 fi = _mm_cvtepi32_ps(idx);
+
+    // Direction du filament, courbée le long de t
+    const __m128 bend = _mm_mul_ps(_mm_sub_ps(t, _mm_set1_ps(0.5f)), _mm_set1_ps(e.bend));
+    __m128 dx = _mm_add_ps(bx, _mm_mul_ps(by, bend));
+    __m128 dy = _mm_sub_ps(by, _mm_mul_ps(bx, bend));
+    __m128 dz = bz;
+    const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    const __m128 invLen = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(len2));
+    dx = _mm_mul_ps(dx, invLen); dy = _mm_mul_ps(dy, invLen); dz = _mm_mul_ps(dz, invLen);
+
+    // Forme ovoïde
+    const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_set1_ps(e.radiusMin), _mm_mul_ps(t, _mm_set1_ps(e.radiusRange))),
+                                     _mm_mul_ps(uRadius, _mm_set1_ps(e.radiusJitter)));
+    __m128 ox = _mm_mul_ps(dx, radius);
+    __m128 oy = _mm_mul_ps(_mm_mul_ps(dy, radius), _mm_set1_ps(e.stretchY));
+    __m128 oz = _mm_mul_ps(dz, radius);
+
+    // Vagues et arcs
+    __m128 waveSin, waveCos, arcSin, arcCos, noiseSin, noiseCos;
+    sinCos4(_mm_add_ps(_mm_mul_ps(radius, _mm_set1_ps(e.waveFrequency)), fi), waveSin, waveCos);
+    sinCos4(_mm_add_ps(fi, _mm_mul_ps(t, _mm_set1_ps(6.28f))), arcSin, arcCos);
+    sinCos4(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, _mm_set1_ps(2.1f)), _mm_mul_ps(oy, _mm_set1_ps(1.3f))),
+                       _mm_mul_ps(oz, _mm_set1_ps(0.7f))), noiseSin, noiseCos);
+    const __m128 wave = _mm_mul_ps(waveSin, _mm_set1_ps(e.waveAmplitude));
+    ox = _mm_add_ps(ox, _mm_mul_ps(wave, arcCos));
+    oy = _mm_add_ps(oy, _mm_mul_ps(noiseSin, _mm_set1_ps(e.noiseAmplitude)));
+    oz = _mm_add_ps(oz, _mm_mul_ps(wave, arcSin));
+
+    // Anneaux et boucles
+    const __m128 ring = _mm_cmplt_ps(uRing, _mm_set1_ps(e.ringProbability));
+    if (_mm_movemask_ps(ring) != 0) {
+        __m128 ringSin, ringCos, wobbleSin, wobbleCos;
+        sinCos4(_mm_mul_ps(t, _mm_set1_ps(6.28f)), ringSin, ringCos);
+        sinCos4(_mm_add_ps(fi, _mm_mul_ps(t, _mm_set1_ps(3.0f))), wobbleSin, wobbleCos);
+        const __m128 ringRadius = _mm_add_ps(_mm_set1_ps(e.ringRadius), _mm_mul_ps(_mm_set1_ps(e.ringWobble), wobbleSin));
+        ox = select4(ring, _mm_add_ps(ox, _mm_mul_ps(ringCos, ringRadius)), ox);
+        oz = select4(ring, _mm_add_ps(oz, _mm_mul_ps(ringSin, ringRadius)), oz);
+    }
+
+    const __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oy, oy)), _mm_mul_ps(oz, oz)));
+    const __m128 speed = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_set1_ps(e.speedMin), _mm_mul_ps(t, _mm_set1_ps(e.speedRange))),
+                                               _mm_mul_ps(uSpeed, _mm_set1_ps(e.speedJitter))),
+                                    _mm_set1_ps(p.speedScale));
+    const __m128 life = _mm_add_ps(_mm_add_ps(_mm_set1_ps(e.lifeMin), _mm_mul_ps(t, _mm_set1_ps(e.lifeRange))),
+                                   _mm_mul_ps(uLife, _mm_set1_ps(e.lifeJitter)));
+
+    const __m128 x = _mm_add_ps(_mm_set1_ps(e.center.x), ox);
+    const __m128 y = _mm_add_ps(_mm_set1_ps(e.center.y), oy);
+    const __m128 z = _mm_add_ps(_mm_set1_ps(e.center.z), oz);
+    _mm_storeu_ps(s.x + i, x);  _mm_storeu_ps(s.px + i, x);
+    _mm_storeu_ps(s.y + i, y);  _mm_storeu_ps(s.py + i, y);
+    _mm_storeu_ps(s.z + i, z);  _mm_storeu_ps(s.pz + i, z);
+    _mm_storeu_ps(s.vx + i, _mm_mul_ps(dx, speed));
+    _mm_storeu_ps(s.vy + i, _mm_mul_ps(dy, speed));
+    _mm_storeu_ps(s.vz + i, _mm_mul_ps(dz, speed));
+    _mm_storeu_ps(s.life + i, life);
+
+    // Couleur selon la zone : zones voie par voie, mélanges en SIMD
+    __m128i tiers;
+    __m128 density = _mm_setzero_ps();
+    if (p.sph && p.sph->meanDensity() > 0.0f) {
+        alignas(16) float laneX[4], laneY[4], laneZ[4], laneDist[4], laneDensity[4];
+        alignas(16) int32_t tier[4];
+        _mm_store_ps(laneX, x); _mm_store_ps(laneY, y); _mm_store_ps(laneZ, z);
+        _mm_store_ps(laneDist, dist);
+        for (int k = 0; k < 4; ++k) tier[k] = shellTier(laneX[k], laneY[k], laneZ[k], laneDist[k], p, laneDensity[k]);
+        tiers = _mm_load_si128(reinterpret_cast<const __m128i*>(tier));
+        density = _mm_load_ps(laneDensity);
+    } else {
+        // tierFromDistance sans branchement : nombre de rayons dépassés
+        tiers = _mm_setzero_si128();
+        for (float radius : tierRadius) {
+            tiers = _mm_sub_epi32(tiers, _mm_castps_si128(_mm_cmpge_ps(dist, _mm_set1_ps(radius))));
+        }
+    }
+    const __m128 core = _mm_castsi128_ps(_mm_cmpeq_epi32(tiers, _mm_set1_epi32(0)));
+    const __m128 inner = _mm_castsi128_ps(_mm_cmpeq_epi32(tiers, _mm_set1_epi32(1)));
+    const __m128 mid = _mm_castsi128_ps(_mm_cmpeq_epi32(tiers, _mm_set1_epi32(2)));
+    const __m128 dust = _mm_cmplt_ps(uDust, _mm_set1_ps(e.dustProbability));
+    const __m128 u = _mm_sub_ps(_mm_set1_ps(1.0f), t);
+    float* out[3] = {s.r, s.g, s.b};
+    for (int c = 0; c < 3; ++c) {
+        const __m128 innerColor = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e.innerColorA[c]), u),
+                                             _mm_mul_ps(_mm_set1_ps(e.innerColorB[c]), t));
+        const __m128 midColor = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e.midColorA[c]), u),
+                                           _mm_mul_ps(_mm_set1_ps(e.midColorB[c]), t));
+        __m128 color = select4(mid, midColor, _mm_set1_ps(e.outerColor[c]));
+        color = select4(inner, innerColor, color);
+        color = select4(core, _mm_set1_ps(e.coreColor[c]), color);
+        _mm_storeu_ps(out[c] + i, select4(dust, _mm_set1_ps(e.dustColor[c]), color));
+    }
+    _mm_storeu_ps(s.density + i, density);
+}
+
+// Quatre particules de l'onde de choc, mêmes calculs que shockScalar
+void shock4(const Streams& s, std::size_t i, uint64_t serial, const EmitterSettings& e, uint64_t seed) {
+    __m128i blocks[1][4];
+    philoxBlocks(blocks, seed, serial, RngDomain::Shock);
+    const __m128i* block = blocks[0];
+    const __m128 theta = _mm_mul_ps(_mm_mul_ps(uniform4(block[0]), _mm_set1_ps(2.0f)), _mm_set1_ps(3.14159f));
+    const __m128 phi = _mm_mul_ps(uniform4(block[1]), _mm_set1_ps(3.14159f));
+    const __m128 speed = _mm_add_ps(_mm_set1_ps(e.shockSpeed), _mm_mul_ps(uniform4(block[2]), _mm_set1_ps(e.shockSpeedJitter)));
+    __m128 thetaSin, thetaCos, phiSin, phiCos;
+    sinCos4(theta, thetaSin, thetaCos);
+    sinCos4(phi, phiSin, phiCos);
+
+    const __m128 x = _mm_set1_ps(e.center.x), y = _mm_set1_ps(e.center.y), z = _mm_set1_ps(e.center.z);
+    _mm_storeu_ps(s.x + i, x);  _mm_storeu_ps(s.px + i, x);
+    _mm_storeu_ps(s.y + i, y);  _mm_storeu_ps(s.py + i, y);
+    _mm_storeu_ps(s.z + i, z);  _mm_storeu_ps(s.pz + i, z);
+    _mm_storeu_ps(s.vx + i, _mm_mul_ps(_mm_mul_ps(phiSin, thetaCos), speed));
+    _mm_storeu_ps(s.vy + i, _mm_mul_ps(_mm_mul_ps(phiSin, thetaSin), speed));
+    _mm_storeu_ps(s.vz + i, _mm_mul_ps(phiCos, speed));
+    _mm_storeu_ps(s.r + i, _mm_set1_ps(e.shockColor.r));
+    _mm_storeu_ps(s.g + i, _mm_set1_ps(e.shockColor.g));
+    _mm_storeu_ps(s.b + i, _mm_set1_ps(e.shockColor.b));
+    _mm_storeu_ps(s.life + i, _mm_set1_ps(e.shockLife));
+    _mm_storeu_ps(s.density + i, _mm_setzero_ps());
+}
+
+#endif
+
+} // namespace
+
+void spawnShell(ParticleStore& store, std::size_t first, std::size_t count, uint64_t serial,
+                const EmitterSettings& emitter, const SpawnParams& params) {
+    const Streams s = streamsOf(store);
+    std::size_t i = 0;
+#if defined(SUPERNOVA_SPAWN_SSE)
+    for (; i + 4 <= count; i += 4) shell4(s, first + i, serial + i, emitter, params);
+#endif
+    for (; i < count; ++i) shellScalar(s, first + i, serial + i, emitter, params); // reste
+}
+
+void spawnShock(ParticleStore& store, std::size_t first, std::size_t count, uint64_t serial,
+                const EmitterSettings& emitter, uint64_t seed) {
+    const Streams s = streamsOf(store);
+    std::size_t i = 0;
+#if defined(SUPERNOVA_SPAWN_SSE)
+    for (; i + 4 <= count; i += 4) shock4(s, first + i, serial + i, emitter, seed);
+#endif
+    for (; i < count; ++i) shockScalar(s, first + i, serial + i, emitter, seed); // reste
+}
+
+void spawnShellScalar(ParticleStore& store, std::size_t first, std::size_t count, uint64_t serial,
+                      const EmitterSettings& emitter, const SpawnParams& params) {
+    const Streams s = streamsOf(store);
+    for (std::size_t i = 0; i < count; ++i) shellScalar(s, first + i, serial + i, emitter, params);
+}
+
+void spawnShockScalar(ParticleStore& store, std::size_t first, std::size_t count, uint64_t serial,
+                      const EmitterSettings& emitter, uint64_t seed) {
+    const Streams s = streamsOf(store);
+    for (std::size_t i = 0; i < count; ++i) shockScalar(s, first + i, serial + i, emitter, seed);
+}
@@ -0,0 +1,222 @@
+// src/sph.cpp
+// Hydrodynamique SPH : densité, pression et viscosité artificielle entre éjectas
+#include "sph.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+constexpr std::size_t sumBlock = 4096;
+constexpr float pi = 3.14159265f;
+
+} // namespace
+
+SphSolver::SphSolver(std::size_t capacity, float smoothingLength)
+    : grid(capacity, smoothingLength),
+      svx(capacity), svy(capacity), svz(capacity), srho(capacity), spress(capacity),
+      blockSums(((capacity + sumBlock - 1) / sumBlock + 1) * 4)
+{
+    last.smoothingLength = smoothingLength > 0.0f ? smoothingLength : 0.1f;
+}
+
+// Mean spacing of a uniform ball holding the cloud (R = sqrt(5/3) * RMS radius)
+float SphSolver::automaticSmoothingLength(const ParticleStore& store, ThreadPool& pool) {
+    const std::size_t count = store.size();
+    const std::size_t blocks = (count + sumBlock - 1) / sumBlock;
+    pool.parallelFor(blocks, 1, [&](std::size_t first, std::size_t lastBlock) {
+        for (std::size_t blk = first; blk < lastBlock; ++blk) {
+            double sx = 0.0, sy = 0.0, sz = 0.0, s2 = 0.0;
+            std::size_t end = std::min((blk + 1) * sumBlock, count);
+            for (std::size_t i = blk * sumBlock; i < end; ++i) {
+                double x = store.x[i], y = store.y[i], z = store.z[i];
+                sx += x; sy += y; sz += z; s2 += x * x + y * y + z * z;
+            }
+            double* out = blockSums.data() + blk * 4;
+            out[0] = sx; out[1] = sy; out[2] = sz; out[3] = s2;
+        }
+    });
+    double sum[4] = {0.0, 0.0, 0.0, 0.0};
+    for (std::size_t blk = 0; blk < blocks; ++blk) {
+        for (int c = 0; c < 4; ++c) sum[c] += blockSums[blk * 4 + c];
+    }
+    double inv = 1.0 / double(count);
+    double cx = sum[0] * inv, cy = sum[1] * inv, cz = sum[2] * inv;
+    double variance = std::max(sum[3] * inv - (cx * cx + cy * cy + cz * cz), 1e-6);
+    double radius = std::sqrt(5.0 / 3.0 * variance);
+    double spacing = std::cbrt(4.0 / 3.0 * 3.14159265 * radius * radius * radius * inv);
+    return float(std::max(spacing, 1e-3));
+}
+
+void SphSolver::step(ParticleStore& store, const SphParams& params, float* ax, float* ay, float* az,
+                     bool accumulate, ThreadPool& pool) {
+    const std::size_t count = store.size();
+    last = params;
+    if (count == 0) {
+        grid.rebuild(store.x.data(), store.y.data(), store.z.data(), 0, pool);
+        mean = 0.0f;
+        return;
+    }
+    const bool automatic = last.smoothingLength <= 0.0f;
+    if (automatic) {
+        if (autoLength <= 0.0f) autoLength = automaticSmoothingLength(store, pool);
+        last.smoothingLength = autoLength;
+    }
+    grid.setCellSize(last.smoothingLength);
+    grid.rebuild(store.x.data(), store.y.data(), store.z.data(), count, pool);
+
+    const uint32_t* order = grid.order();
+    const float* sx = grid.sortedX();
+    const float* sy = grid.sortedY();
+    const float* sz = grid.sortedZ();
+
+    const float h = last.smoothingLength;
+    const float h2 = h * h;
+    const float maxAccel = params.deltaTime > 0.0f ? h / (16.0f * params.deltaTime * params.deltaTime) : 0.0f;
+    const float poly6 = params.particleMass * 315.0f / (64.0f * pi * std::pow(h, 9.0f));
+    const float spiky = 45.0f / (pi * std::pow(h, 6.0f));
+    const float c2 = params.soundSpeed * params.soundSpeed;
+
+    // --- Densité ---
+    std::atomic<uint64_t> pairTotal{0}; // somme entière : même résultat quel que soit le découpage
+    pool.parallelFor(count, 512, [&](std::size_t begin, std::size_t end) {
+        uint64_t pairs = 0;
+        SpatialGrid::Range ranges[27];
+        int rangeCount = 0;
+        int cx = 0, cy = 0, cz = 0;
+        bool haveCell = false;
+        for (std::size_t k = begin; k < end; ++k) {
+            const float px = sx[k], py = sy[k], pz = sz[k];
+            int ix = grid.cellCoord(px), iy = grid.cellCoord(py), iz = grid.cellCoord(pz);
+            if (!haveCell || ix != cx || iy != cy || iz != cz) {
+                rangeCount = grid.neighbourRanges(ix, iy, iz, ranges);
+                cx = ix; cy = iy; cz = iz;
+                haveCell = true;
+            }
+
+            float rho = 0.0f;
+            for (int b = 0; b < rangeCount; ++b) {
+                for (uint32_t j = ranges[b].begin; j < ranges[b].end; ++j) {
+                    float dx = sx[j] - px, dy = sy[j] - py, dz = sz[j] - pz;
+                    float r2 = dx * dx + dy * dy + dz * dz;
+                    float d = std::max(h2 - r2, 0.0f); // sans branche : ~2/3 des candidats sont hors noyau
+                    rho += d * d * d;
+                    pairs += r2 < h2;
+                }
+            }
+            rho *= poly6;
+            srho[k] = rho;
+            spress[k] = c2 / rho; // p / rho^2, le terme de pression de la paire
+
+            uint32_t i = order[k];
+            svx[k] = store.vx[i]; svy[k] = store.vy[i]; svz[k] = store.vz[i];
+            store.density[i] = rho;
+        }
+        pairTotal.fetch_add(pairs, std::memory_order_relaxed);
+    });
+    neighbours = float(double(pairTotal.load()) / double(count));
+    if (automatic) {
+        // Le nombre de voisins croît à peu près comme h^2 le long des filaments
+        float scale = std::sqrt(params.targetNeighbours / std::max(neighbours, 1.0f));
+        autoLength = h * std::clamp(scale, 0.7f, 1.3f);
+    }
+
+    // --- Pression + viscosité artificielle ---
+    pool.parallelFor(count, 512, [&](std::size_t begin, std::size_t end) {
+        SpatialGrid::Range ranges[27];
+        int rangeCount = 0;
+        int cx = 0, cy = 0, cz = 0;
+        bool haveCell = false;
+        for (std::size_t k = begin; k < end; ++k) {
+            const float px = sx[k], py = sy[k], pz = sz[k];
+            const float vxk = svx[k], vyk = svy[k], vzk = svz[k];
+            const float rhoK = srho[k];
+            const float termK = spress[k];
+            int ix = grid.cellCoord(px), iy = grid.cellCoord(py), iz = grid.cellCoord(pz);
+            if (!haveCell || ix != cx || iy != cy || iz != cz) {
+                rangeCount = grid.neighbourRanges(ix, iy, iz, ranges);
+                cx = ix; cy = iy; cz = iz;
+                haveCell = true;
+            }
+
+            float accX = 0.0f, accY = 0.0f, accZ = 0.0f;
+            for (int b = 0; b < rangeCount; ++b) {
+                for (uint32_t j = ranges[b].begin; j < ranges[b].end; ++j) {
+                    float rx = px - sx[j], ry = py - sy[j], rz = pz - sz[j];
+                    float r2 = rx * rx + ry * ry + rz * rz;
+                    if (r2 >= h2 || r2 == 0.0f) continue;
+
+                    float r = std::sqrt(r2);
+                    float q = h - r;
+                    float gradient = spiky * q * q / r;  // |grad W| / r
+
+                    float term = termK + spress[j];
+                    float vr = (vxk - svx[j]) * rx + (vyk - svy[j]) * ry + (vzk - svz[j]) * rz;
+                    if (vr < 0.0f) {
+                        // Particules qui se rapprochent : viscosité de Monaghan
+                        float mu = h * vr / (r2 + 0.01f * h2);
+                        float rhoBar = 0.5f * (rhoK + srho[j]);
+                        term += (-params.viscosityAlpha * params.soundSpeed * mu
+                                 + params.viscosityBeta * mu * mu) / rhoBar;
+                    }
+
+                    float f = params.particleMass * term * gradient;
+                    accX += f * rx; accY += f * ry; accZ += f * rz;
+                }
+            }
+
+            if (maxAccel > 0.0f) {
+                float a2 = accX * accX + accY * accY + accZ * accZ;
+                if (a2 > maxAccel * maxAccel) {
+                    float s = maxAccel / std::sqrt(a2);
+                    accX *= s; accY *= s; accZ *= s;
+                }
+            }
+
+            uint32_t i = order[k];
+            if (accumulate) {
+                ax[i] += accX; ay[i] += accY; az[i] += accZ;
+            } else {
+                ax[i] = accX; ay[i] = accY; az[i] = accZ;
+            }
+        }
+    });
+
+    // Densité moyenne (référence des zones de rendu), réduction par blocs fixes
+    const std::size_t blocks = (count + sumBlock - 1) / sumBlock;
+    pool.parallelFor(blocks, 1, [&](std::size_t first, std::size_t lastBlock) {
+        for (std::size_t blk = first; blk < lastBlock; ++blk) {
+            double sum = 0.0;
+            std::size_t end = std::min((blk + 1) * sumBlock, count);
+            for (std::size_t k = blk * sumBlock; k < end; ++k) sum += srho[k];
+            blockSums[blk] = sum;
+        }
+    });
+    double total = 0.0;
+    for (std::size_t blk = 0; blk < blocks; ++blk) total += blockSums[blk];
+    mean = float(total / double(count));
+}
+
+float SphSolver::sampleDensity(float x, float y, float z) const {
+    if (grid.size() == 0) return 0.0f;
+    const float h = last.smoothingLength;
+    const float h2 = h * h;
+    const float* sx = grid.sortedX();
+    const float* sy = grid.sortedY();
+    const float* sz = grid.sortedZ();
+
+    SpatialGrid::Range ranges[27];
+    int rangeCount = grid.neighbourRanges(grid.cellCoord(x), grid.cellCoord(y), grid.cellCoord(z), ranges);
+    float rho = 0.0f;
+    for (int b = 0; b < rangeCount; ++b) {
+        for (uint32_t j = ranges[b].begin; j < ranges[b].end; ++j) {
+            float dx = sx[j] - x, dy = sy[j] - y, dz = sz[j] - z;
+            float r2 = dx * dx + dy * dy + dz * dz;
+            if (r2 < h2) {
+                float d = h2 - r2;
+                rho += d * d * d;
+            }
+        }
+    }
+    return rho * last.particleMass * 315.0f / (64.0f * pi * std::pow(h, 9.0f));
+}
@@ -0,0 +1,372 @@
+// src/splat_renderer.cpp
+// Rendu CPU des billboards : projection, tri par profondeur, tuiles de 64x64 pixels
+// rastérisées en parallèle
+#include "splat_renderer.h"
+#include "particle_sprite.h"
+#include "profiler.h"
+#include "shell_tiers.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if !defined(SUPERNOVA_FORCE_SCALAR)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SUPERNOVA_SPLAT_SSE 1
+#    include <emmintrin.h>
+#  endif
+#endif
+
+// Découpage du binning : fixe, pour que l'ordre dans chaque tuile ne dépende pas des threads
+static constexpr std::size_t binChunks = 64;
+
+// Le niveau de mip le plus proche garde au plus ~1.41 texel par pixel : une ligne de
+// tuile touche donc moins de 2 * tileSize + 4 texels
+static constexpr int rowTexels = 2 * SplatRenderer::tileSize + 4;
+
+// Sous cette transmittance, ce qui reste derrière change un pixel de moins d'un
+// demi-niveau sur 8 bits
+static constexpr float opaqueTransmittance = 0.5f / 255.0f;
+
+SplatRenderer::SplatRenderer(int width, int height, std::size_t capacity, unsigned int threadCount)
+    : frameWidth(std::max(width, 1)), frameHeight(std::max(height, 1)),
+      tilesX((frameWidth + tileSize - 1) / tileSize), tilesY((frameHeight + tileSize - 1) / tileSize),
+      capacity(capacity), pool(threadCount), sorter(capacity), splats(capacity + 1),
+      framebuffer(std::size_t(frameWidth) * frameHeight * 4),
+      chunkCounts(binChunks * std::size_t(tilesX) * tilesY), tileStart(std::size_t(tilesX) * tilesY + 1)
+{
+    const int size = 64;
+    std::vector<unsigned char> halo = gaussianSprite(size);
+    setSprite(size, size, halo.data());
+}
+
+static inline float* texelAt(std::vector<float>& texels, int paddedWidth, int i, int j) {
+    return texels.data() + (std::size_t(j) * paddedWidth + i) * 4;
+}
+
+// Bord d'un texel répété autour du niveau : l'échantillonnage n'a plus de cas limite
+static void padLevel(std::vector<float>& texels, int width, int height) {
+    const int pw = width + 2;
+    for (int j = 1; j <= height; ++j) {
+        std::copy_n(texelAt(texels, pw, 1, j), 4, texelAt(texels, pw, 0, j));
+        std::copy_n(texelAt(texels, pw, width, j), 4, texelAt(texels, pw, width + 1, j));
+    }
+    std::copy_n(texelAt(texels, pw, 0, 1), pw * 4, texelAt(texels, pw, 0, 0));
+    std::copy_n(texelAt(texels, pw, 0, height), pw * 4, texelAt(texels, pw, 0, height + 1));
+}
+
+bool SplatRenderer::setSprite(int width, int height, const unsigned char* rgba) {
+    if (width <= 0 || height <= 0 || !rgba) return false;
+
+    std::vector<SpriteLevel> levels;
+    SpriteLevel base{width, height, std::vector<float>(std::size_t(width + 2) * (height + 2) * 4)};
+    for (int j = 0; j < height; ++j) {
+        for (int i = 0; i < width; ++i) {
+            const unsigned char* in = rgba + (std::size_t(j) * width + i) * 4;
+            float* out = texelAt(base.texels, width + 2, i + 1, j + 1);
+            for (int c = 0; c < 4; ++c) out[c] = in[c] / 255.0f;
+        }
+    }
+    padLevel(base.texels, width, height);
+    levels.push_back(std::move(base));
+
+    // Chaîne de mips par moyenne 2x2, comme glGenerateMipmap
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        SpriteLevel& up = levels.back();
+        const int w = std::max(up.width / 2, 1);
+        const int h = std::max(up.height / 2, 1);
+        SpriteLevel next{w, h, std::vector<float>(std::size_t(w + 2) * (h + 2) * 4)};
+        for (int j = 0; j < h; ++j) {
+            for (int i = 0; i < w; ++i) {
+                const int i0 = 2 * i + 1, i1 = std::min(2 * i + 1, up.width - 1) + 1;
+                const int j0 = 2 * j + 1, j1 = std::min(2 * j + 1, up.height - 1) + 1;
+                float* out = texelAt(next.texels, w + 2, i + 1, j + 1);
+                for (int c = 0; c < 4; ++c) {
+                    out[c] = 0.25f * (texelAt(up.texels, up.width + 2, i0, j0)[c] + texelAt(up.texels, up.width + 2, i1, j0)[c] +
+                                      texelAt(up.texels, up.width + 2, i0, j1)[c] + texelAt(up.texels, up.width + 2, i1, j1)[c]);
+                }
+            }
+        }
+        padLevel(next.texels, w, h);
+        levels.push_back(std::move(next));
+    }
+    sprite = std::move(levels);
+    return true;
+}
+
+std::size_t SplatRenderer::project(const ParticleView& frame, const uint32_t* order, std::size_t count,
+                                   const glm::mat4& view, const glm::mat4& projection) {
+    const glm::mat4 viewProjection = projection * view;
+    const float halfWidth = 0.5f * float(frameWidth);
+    const float halfHeight = 0.5f * float(frameHeight);
+    const float spriteWidth = float(sprite[0].width);
+    const float spriteHeight = float(sprite[0].height);
+    const int lastLevel = int(sprite.size()) - 1;
+
+    // Même géométrie que shaders/vertex.glsl : carré face à la caméra de demi-côté `size`
+    auto place = [&](Splat& s, const glm::vec3& position, float size, float r, float g, float b, float alpha) {
+        s.px0 = s.py0 = s.px1 = s.py1 = 0;
+        const glm::vec4 clip = viewProjection * glm::vec4(position, 1.0f);
+        if (clip.w <= 0.0f || clip.z < -clip.w || clip.z > clip.w) return;   // hors des plans near / far
+
+        const float invW = 1.0f / clip.w;
+        const float cx = (clip.x * invW + 1.0f) * halfWidth;
+        const float cy = (1.0f - clip.y * invW) * halfHeight;             // ligne 0 en haut
+        const float hx = std::fabs(projection[0][0]) * size * invW * halfWidth;
+        const float hy = std::fabs(projection[1][1]) * size * invW * halfHeight;
+
+        // Pixels dont le centre tombe dans le carré
+        s.px0 = int(std::clamp(std::ceil(cx - hx - 0.5f), 0.0f, float(frameWidth)));
+        s.px1 = int(std::clamp(std::ceil(cx + hx - 0.5f), 0.0f, float(frameWidth)));
+        s.py0 = int(std::clamp(std::ceil(cy - hy - 0.5f), 0.0f, float(frameHeight)));
+        s.py1 = int(std::clamp(std::ceil(cy + hy - 0.5f), 0.0f, float(frameHeight)));
+        if (s.px0 >= s.px1 || s.py0 >= s.py1) {
+            s.px0 = s.py0 = s.px1 = s.py1 = 0;
+            return;
+        }
+
+        const float texelsPerPixel = std::max(spriteWidth / (2.0f * hx), spriteHeight / (2.0f * hy));
+        s.level = texelsPerPixel > 1.0f ? std::min(int(std::log2(texelsPerPixel) + 0.5f), lastLevel) : 0;
+        s.x0 = cx - hx;
+        s.y0 = cy - hy;
+        s.texelsX = float(sprite[s.level].width) / (2.0f * hx);
+        s.texelsY = float(sprite[s.level].height) / (2.0f * hy);
+        s.color[0] = r;
+        s.color[1] = g;
+        s.color[2] = b;
+        s.color[3] = alpha;
+    };
+
+    // En SPH, la taille suit la densité locale plutôt que la distance au centre
+    const bool byDensity = frame.densityReference > 0.0f && frame.density != nullptr;
+
+    // Flash central (pic lumineux) à sa profondeur : les particules plus proches sont décalées d'un cran
+    const bool flash = frame.elapsed < 0.1f;
+    const std::size_t flashSlot = flash ? sorter.slotFor(frame.center) : count;
+    pool.parallelFor(count, 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            const uint32_t i = order[k];
+            const glm::vec3 position(frame.x[i], frame.y[i], frame.z[i]);
+            const int tier = byDensity ? tierFromDensity(frame.density[i], frame.densityReference)
+                                       : tierFromDistance(glm::length(position - frame.center));
+            place(splats[k + (k >= flashSlot)], position, tierSize(tier), std::clamp(frame.r[i], 0.0f, 1.0f),
+                  std::clamp(frame.g[i], 0.0f, 1.0f), std::clamp(frame.b[i], 0.0f, 1.0f),
+                  std::clamp(frame.life[i], 0.2f, 1.0f));
+        }
+    });
+
+    if (flash) {
+        place(splats[flashSlot], frame.center, tierSize(0), 1.0f, 1.0f, 1.0f, 1.0f - frame.elapsed * 10.0f);
+        return count + 1;
+    }
+    return count;
+}
+
+void SplatRenderer::bin(std::size_t count) {
+    // Comptage par (morceau, tuile), décalages, puis écriture : chaque tuile reçoit
+    // ses billboards dans l'ordre du tri, de l'arrière vers l'avant
+    const std::size_t tiles = std::size_t(tilesX) * tilesY;
+    const std::size_t chunks = std::clamp<std::size_t>((count + 1023) / 1024, 1, binChunks);
+    auto forEachTile = [&](const Splat& s, auto&& fn) {
+        const int tx0 = s.px0 / tileSize, tx1 = (s.px1 - 1) / tileSize;
+        const int ty0 = s.py0 / tileSize, ty1 = (s.py1 - 1) / tileSize;
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) fn(std::size_t(ty) * tilesX + tx);
+        }
+    };
+
+    std::atomic<std::size_t> visible{0};
+    pool.parallelFor(chunks, 1, [&](std::size_t firstChunk, std::size_t lastChunk) {
+        for (std::size_t c = firstChunk; c < lastChunk; ++c) {
+            uint32_t* counts = chunkCounts.data() + c * tiles;
+            std::fill(counts, counts + tiles, 0u);
+            std::size_t onScreen = 0;
+            for (std::size_t k = count * c / chunks; k < count * (c + 1) / chunks; ++k) {
+                if (splats[k].px1 == 0) continue;
+                ++onScreen;
+                forEachTile(splats[k], [&](std::size_t t) { ++counts[t]; });
+            }
+            visible.fetch_add(onScreen, std::memory_order_relaxed);
+        }
+    });
+
+    uint32_t total = 0;
+    for (std::size_t t = 0; t < tiles; ++t) {
+        tileStart[t] = total;
+        for (std::size_t c = 0; c < chunks; ++c) {
+            uint32_t& slot = chunkCounts[c * tiles + t];
+            const uint32_t n = slot;
+            slot = total;
+            total += n;
+        }
+    }
+    tileStart[tiles] = total;
+    if (entries.size() < total) entries.resize(total);
+
+    pool.parallelFor(chunks, 1, [&](std::size_t firstChunk, std::size_t lastChunk) {
+        for (std::size_t c = firstChunk; c < lastChunk; ++c) {
+            uint32_t* offsets = chunkCounts.data() + c * tiles;
+            for (std::size_t k = count * c / chunks; k < count * (c + 1) / chunks; ++k) {
+                if (splats[k].px1 == 0) continue;
+                forEachTile(splats[k], [&](std::size_t t) { entries[offsets[t]++] = uint32_t(k); });
+            }
+        }
+    });
+
+    drawn = visible.load();
+    binned = total;
+}
+
+// Interpolation verticale entre deux lignes du sprite (texels RGBA)
+static void lerpRow(const float* top, const float* bottom, float fy, float* out, int texels) {
+#if defined(SUPERNOVA_SPLAT_SSE)
+    const __m128 f = _mm_set1_ps(fy);
+    for (int k = 0; k < texels; ++k) {
+        const __m128 a = _mm_loadu_ps(top + 4 * k);
+        const __m128 b = _mm_loadu_ps(bottom + 4 * k);
+        _mm_store_ps(out + 4 * k, _mm_add_ps(a, _mm_mul_ps(f, _mm_sub_ps(b, a))));
+    }
+#else
+    for (int k = 0; k < 4 * texels; ++k) out[k] = top[k] + fy * (bottom[k] - top[k]);
+#endif
+}
+
+// Une ligne de pixels : interpolation horizontale (colonne et poids précalculés,
+// identiques pour toutes les lignes), puis composition de l'avant vers l'arrière.
+// Le pixel garde (couleur accumulée, transmittance T) : C += T * a * c, T *= 1 - a,
+// ce qui donne sur fond noir le même résultat que GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA
+// de l'arrière vers l'avant. Renvoie la plus grande transmittance de la ligne.
+static float blendRow(float* dst, int n, const float* row, const int* column, const float* weight,
+                      const float* color) {
+#if defined(SUPERNOVA_SPLAT_SSE)
+    const __m128 c = _mm_loadu_ps(color);
+    __m128 open = _mm_setzero_ps();
+    const __m128 rgbMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    const __m128 minusOneW = _mm_set_ps(-1.0f, 0.0f, 0.0f, 0.0f);
+    for (int p = 0; p < n; ++p) {
+        const __m128 f = _mm_set1_ps(weight[p]);
+        const float* t = row + column[p];
+        const __m128 t0 = _mm_load_ps(t);
+        const __m128 texel = _mm_add_ps(t0, _mm_mul_ps(f, _mm_sub_ps(_mm_load_ps(t + 4), t0)));
+        const __m128 s = _mm_mul_ps(c, texel);
+        const __m128 d = _mm_load_ps(dst + 4 * p);
+        // w = T * a ; (r, g, b, T) + w * (r, g, b, -1)
+        const __m128 w = _mm_mul_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 3, 3, 3)),
+                                    _mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 3, 3)));
+        const __m128 source = _mm_or_ps(_mm_and_ps(s, rgbMask), minusOneW);
+        const __m128 blended = _mm_add_ps(d, _mm_mul_ps(w, source));
+        _mm_store_ps(dst + 4 * p, blended);
+        open = _mm_max_ps(open, blended);
+    }
+    return _mm_cvtss_f32(_mm_shuffle_ps(open, open, _MM_SHUFFLE(3, 3, 3, 3)));
+#else
+    float open = 0.0f;
+    for (int p = 0; p < n; ++p) {
+        const float f = weight[p];
+        const float* t = row + column[p];
+        float s[4];
+        for (int k = 0; k < 4; ++k) s[k] = color[k] * (t[k] + f * (t[k + 4] - t[k]));
+        float* d = dst + 4 * p;
+        const float w = d[3] * s[3];
+        for (int k = 0; k < 3; ++k) d[k] += w * s[k];
+        d[3] -= w;
+        open = std::max(open, d[3]);
+    }
+    return open;
+#endif
+}
+
+void SplatRenderer::rasterize(int tile) {
+    const int cx0 = (tile % tilesX) * tileSize, cx1 = std::min(cx0 + tileSize, frameWidth);
+    const int cy0 = (tile / tilesX) * tileSize, cy1 = std::min(cy0 + tileSize, frameHeight);
+    float* fb = framebuffer.data();
+    auto pixel = [&](int x, int y) { return fb + (std::size_t(y) * frameWidth + x) * 4; };
+    for (int y = cy0; y < cy1; ++y) {
+        for (float* p = pixel(cx0, y); p < pixel(cx1, y); p += 4) {
+            p[0] = p[1] = p[2] = 0.0f;
+            p[3] = 1.0f;                                             // transmittance
+        }
+    }
+
+    // Du plus proche au plus loin. rowOpen majore la transmittance de chaque ligne :
+    // exacte après un billboard couvrant toute la largeur, inchangée sinon. Les lignes
+    // opaques sont sautées, la tuile s'arrête quand toutes le sont.
+    alignas(16) float row[4 * rowTexels];
+    int column[tileSize];
+    float weight[tileSize];
+    float rowOpen[tileSize];
+    std::fill(rowOpen, rowOpen + tileSize, 1.0f);
+    int openRows = cy1 - cy0;
+    for (uint32_t e = tileStart[tile + 1]; e-- > tileStart[tile] && openRows > 0;) {
+        const Splat& s = splats[entries[e]];
+        const SpriteLevel& level = sprite[s.level];
+        const int pw = level.width + 2;
+        const int xa = std::max(cx0, s.px0), xb = std::min(cx1, s.px1);
+        const int ya = std::max(cy0, s.py0), yb = std::min(cy1, s.py1);
+
+        // Colonnes du niveau (bord compris) lues par les pixels [xa, xb)
+        const int firstTexel = int((float(xa) + 0.5f - s.x0) * s.texelsX + 0.5f);
+        const int lastTexel = std::min(int((float(xb - 1) + 0.5f - s.x0) * s.texelsX + 0.5f) + 1, level.width + 1);
+        const int texels = std::min(lastTexel - firstTexel + 1, rowTexels);
+        for (int x = xa; x < xb; ++x) {
+            const float u = (float(x) + 0.5f - s.x0) * s.texelsX + 0.5f;
+            column[x - xa] = 4 * (int(u) - firstTexel);
+            weight[x - xa] = u - float(int(u));
+        }
+
+        const bool fullWidth = xa == cx0 && xb == cx1;
+        for (int y = ya; y < yb; ++y) {
+            float& open = rowOpen[y - cy0];
+            if (open < opaqueTransmittance) continue;
+            const float v = (float(y) + 0.5f - s.y0) * s.texelsY + 0.5f;
+            const int j = std::min(int(v), level.height);
+            const float fy = std::min(v - float(j), 1.0f);
+            const float* top = level.texels.data() + (std::size_t(j) * pw + firstTexel) * 4;
+            lerpRow(top, top + std::size_t(pw) * 4, fy, row, texels);
+            const float left = blendRow(pixel(xa, y), xb - xa, row, column, weight, s.color);
+            if (fullWidth) {
+                open = left;
+                if (open < opaqueTransmittance) --openRows;
+            }
+        }
+    }
+
+    // Transmittance -> couverture
+    for (int y = cy0; y < cy1; ++y) {
+        for (float* p = pixel(cx0, y); p < pixel(cx1, y); p += 4) p[3] = 1.0f - p[3];
+    }
+}
+
+void SplatRenderer::render(const ParticleView& frame, const glm::mat4& view, const glm::mat4& projection) {
+    SUPERNOVA_PROFILE_SCOPE("splat render");
+    const std::size_t count = std::min(frame.count, capacity);
+
+    const uint32_t* order = nullptr;
+    {
+        SUPERNOVA_PROFILE_SCOPE("splat sort");
+        order = sorter.sort(frame, view, pool);
+    }
+    std::size_t total = 0;
+    {
+        SUPERNOVA_PROFILE_SCOPE("splat project");
+        total = project(frame, order, count, view, projection);
+    }
+    {
+        SUPERNOVA_PROFILE_SCOPE("splat bin");
+        bin(total);
+    }
+    SUPERNOVA_PROFILE_SCOPE("splat raster");
+    pool.parallelFor(std::size_t(tilesX) * tilesY, 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t t = begin; t < end; ++t) rasterize(int(t));
+    });
+}
+
+void SplatRenderer::resolve(unsigned char* rgb) {
+    const float* fb = framebuffer.data();
+    pool.parallelFor(std::size_t(frameHeight), 16, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t p = begin * frameWidth; p < end * frameWidth; ++p) {
+            for (int c = 0; c < 3; ++c) {
+                rgb[3 * p + c] = (unsigned char)std::lrint(std::clamp(fb[4 * p + c], 0.0f, 1.0f) * 255.0f);
+            }
+        }
+    });
+}
@@ -0,0 +1,100 @@
+// src/thread_pool.cpp
+#include "thread_pool.h"
+#include "profiler.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    start(threadCount);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+void ThreadPool::resize(unsigned threadCount) {
+    stop();
+    start(threadCount);
+}
+
+void ThreadPool::start(unsigned threadCount) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t current;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+        current = generation;
+        startingWorkers = threadCount - 1;
+    }
+    // Les nouveaux workers partent de la génération courante : generation
+    // survit à resize(), sinon ils exécuteraient le dernier job une seconde fois
+    workers.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; ++i) {
+        workers.emplace_back([this, current] { workerLoop(current); });
+    }
+
+    // Attend que chaque worker ait démarré : rien n'est alloué pendant les pas mesurés
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCv.wait(lock, [this] { return startingWorkers == 0; });
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto& t : workers) t.join();
+    workers.clear();
+}
+
+void ThreadPool::run(std::size_t count, std::size_t grain, RangeFn fn, void* ctx) {
+    // ~4 chunks per thread: enough slack for load balancing, few atomics
+    std::size_t chunk = (count + size() * 4 - 1) / (size() * 4);
+    chunk = std::max(chunk, std::max<std::size_t>(grain, 1));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobFn = fn;
+        jobCtx = ctx;
+        jobCount = count;
+        jobChunk = chunk;
+        nextChunk.store(0, std::memory_order_relaxed);
+        activeWorkers = unsigned(workers.size());
+        ++generation;
+    }
+    wakeCv.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCv.wait(lock, [this] { return activeWorkers == 0; });
+}
+
+void ThreadPool::runChunks() {
+    for (;;) {
+        std::size_t begin = nextChunk.fetch_add(1, std::memory_order_relaxed) * jobChunk;
+        if (begin >= jobCount) return;
+        jobFn(jobCtx, begin, std::min(begin + jobChunk, jobCount));
+    }
+}
+
+void ThreadPool::workerLoop(uint64_t seen) {
+    SUPERNOVA_PROFILE_THREAD();              // l'anneau du profileur est alloué avant le premier job
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--startingWorkers == 0) doneCv.notify_all();
+    }
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--activeWorkers == 0) doneCv.notify_one();
+        }
+    }
+}
@@ -0,0 +1,78 @@
+// tools/frame_writer.cpp
+// Encodage des images en arrière-plan (stb_image_write)
+#include "frame_writer.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_STATIC               // SOIL exporte déjà stbi_write_bmp / stbi_write_tga
+#include "stb_image_write.h"
+#include <cstdio>
+
+FrameWriter::FrameWriter(int width, int height, ImageFormat format, unsigned int encoders)
+    : width(width), height(height), format(format)
+{
+    for (unsigned int e = 0; e < encoders; ++e) {
+        jobs.push_back(std::make_unique<Job>());
+        Job& job = *jobs.back();
+        if (format == ImageFormat::Hdr) job.hdr.resize(std::size_t(width) * height * 4);
+        else job.rgb.resize(std::size_t(width) * height * 3);
+        job.thread = std::thread([this, &job] { encodeLoop(job); });
+    }
+}
+
+FrameWriter::~FrameWriter() {
+    finish();
+}
+
+FrameWriter::Job& FrameWriter::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    Job* idle = nullptr;
+    idleCv.wait(lock, [&] {
+        for (const std::unique_ptr<Job>& job : jobs) {
+            if (!job->queued) idle = job.get();
+        }
+        return idle != nullptr;
+    });
+    return *idle;
+}
+
+void FrameWriter::queue(Job& job, const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    job.path = path;
+    job.queued = true;
+    queuedCv.notify_all();
+}
+
+bool FrameWriter::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    queuedCv.notify_all();
+    for (const std::unique_ptr<Job>& job : jobs) {
+        if (job->thread.joinable()) job->thread.join();
+    }
+    return !failed;
+}
+
+void FrameWriter::encodeLoop(Job& job) {
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex);
+        queuedCv.wait(lock, [&] { return job.queued || closing; });
+        if (!job.queued) return;             // fermeture, plus rien en attente
+        lock.unlock();
+
+        int ok = 0;
+        switch (format) {
+            case ImageFormat::Png: ok = stbi_write_png(job.path.c_str(), width, height, 3, job.rgb.data(), width * 3); break;
+            case ImageFormat::Tga: ok = stbi_write_tga(job.path.c_str(), width, height, 3, job.rgb.data()); break;
+            case ImageFormat::Hdr: ok = stbi_write_hdr(job.path.c_str(), width, height, 4, job.hdr.data()); break;
+        }
+
+        lock.lock();
+        if (!ok) {
+            std::fprintf(stderr, "cannot write %s\n", job.path.c_str());
+            failed = true;
+        }
+        job.queued = false;
+        idleCv.notify_all();
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class ImageFormat { Png, Tga, Hdr };   // 8-bit RGB, 8-bit RGB (RLE), float RGB
+
+// Writes an image sequence with stb_image_write on background encoder threads,
+// so the next frame renders while earlier ones are compressed. Each encoder
+// owns one image buffer; submit() only blocks when every encoder is busy.
+class FrameWriter {
+public:
+    FrameWriter(int width, int height, ImageFormat format, unsigned int encoders);
+    ~FrameWriter();                          // finish()
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    // Waits for a free encoder, lets `fill` write its image (unsigned char* RGB,
+    // or float* RGBA for Hdr), then encodes it to `path` in the background.
+    template <typename Fill>
+    void submit(const std::string& path, Fill&& fill) {
+        Job& job = acquire();
+        if (format == ImageFormat::Hdr) fill(job.hdr.data());
+        else fill(job.rgb.data());
+        queue(job, path);
+    }
+
+    // Waits for the last images. False if any of them could not be written.
+    bool finish();
+
+private:
+    struct Job {
+        std::vector<unsigned char> rgb;
+        std::vector<float> hdr;
+        std::string path;
+        bool queued = false;
+        std::thread thread;
+    };
+
+    Job& acquire();
+    void queue(Job& job, const std::string& path);
+    void encodeLoop(Job& job);
+
+    int width;
+    int height;
+    ImageFormat format;
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::mutex mutex;
+    std::condition_variable queuedCv;
+    std::condition_variable idleCv;
+    bool closing = false;
+    bool failed = false;
+};
+
+#endif
@@ -0,0 +1,175 @@
+// tools/supernova_render.cpp
+// Rendu hors ligne sur CPU (pas de fenêtre, pas de GPU) : une image par frame.
+//
+//   supernova_render [--replay FILE] [--frames N] [--size 3840x2160]
+//                    [--out frames/frame_%05d.png] [--particles 2000] [--seed N]
+//                    [--threads 0] [--encoders 0] [--sprite assets/particle2.png]
+//
+// Without --replay the simulation runs live at the viewer's fixed step and
+// every snapshot interval (1/60 s) becomes one image. With --replay each
+// recorded frame does. The camera is the viewer's: 15 units from the center,
+// 60 degree field of view, turning 10 degrees per second of simulated time.
+// The --out extension picks the format: .png, .tga (fast, RLE) or .hdr
+// (float framebuffer). Images are encoded on --encoders background threads
+// (0 = one per hardware thread) while the next frame renders.
+#include "particle_system.h"
+#include "frame_writer.h"
+#include "profiler.h"
+#include "simulation_thread.h"
+#include "snapshot.h"
+#include "splat_renderer.h"
+#include "../external/glm/gtc/matrix_transform.hpp"
+#include "SOIL/stb_image_aug.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+struct RenderOptions {
+    const char* replay = nullptr;
+    long frames = 0;                         // 0 = 300 live, or the whole recording
+    int width = 3840;
+    int height = 2160;
+    std::string out = "frames/frame_%05d.png";
+    unsigned int particles = 2000;           // same pool as the viewer
+    uint64_t seed = ParticleSystem::defaultSeed;
+    unsigned int threads = 0;
+    unsigned int encoders = 0;
+    const char* sprite = "assets/particle2.png";
+};
+
+// Un seul entier dans le motif : %d, %5d ou %05d
+static bool validPattern(const std::string& pattern) {
+    const std::size_t at = pattern.find('%');
+    if (at == std::string::npos || pattern.find('%', at + 1) != std::string::npos) return false;
+    std::size_t i = at + 1;
+    while (i < pattern.size() && pattern[i] >= '0' && pattern[i] <= '9') ++i;
+    return i < pattern.size() && pattern[i] == 'd';
+}
+
+static bool parseOptions(int argc, char** argv, RenderOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) return false;
+        if (std::strcmp(arg, "--replay") == 0) opt.replay = value;
+        else if (std::strcmp(arg, "--frames") == 0) opt.frames = std::strtol(value, nullptr, 10);
+        else if (std::strcmp(arg, "--size") == 0) {
+            if (std::sscanf(value, "%dx%d", &opt.width, &opt.height) != 2) return false;
+        }
+        else if (std::strcmp(arg, "--out") == 0) opt.out = value;
+        else if (std::strcmp(arg, "--particles") == 0) opt.particles = unsigned(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(arg, "--seed") == 0) opt.seed = std::strtoull(value, nullptr, 0);
+        else if (std::strcmp(arg, "--threads") == 0) opt.threads = unsigned(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(arg, "--encoders") == 0) opt.encoders = unsigned(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(arg, "--sprite") == 0) opt.sprite = value;
+        else return false;
+        ++i;
+    }
+    return opt.frames >= 0 && opt.width > 0 && opt.height > 0 && opt.width <= 16384 && opt.height <= 16384 &&
+           opt.particles > 0 && validPattern(opt.out);
+}
+
+static bool formatFor(const std::string& path, ImageFormat& format) {
+    const std::string ext = std::filesystem::path(path).extension().string();
+    if (ext == ".png") format = ImageFormat::Png;
+    else if (ext == ".tga") format = ImageFormat::Tga;
+    else if (ext == ".hdr") format = ImageFormat::Hdr;
+    else return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+    RenderOptions opt;
+    ImageFormat format = ImageFormat::Png;
+    if (!parseOptions(argc, argv, opt) || !formatFor(opt.out, format)) {
+        std::fprintf(stderr, "usage: %s [--replay FILE] [--frames N] [--size WxH] [--out frames/frame_%%05d.png|.tga|.hdr]"
+                             " [--particles N] [--seed N] [--threads N] [--encoders N] [--sprite FILE]\n", argv[0]);
+        return 2;
+    }
+
+    SnapshotReader replay;
+    if (opt.replay && (!replay.open(opt.replay) || replay.frameCount() == 0)) {
+        std::fprintf(stderr, "cannot replay %s\n", opt.replay);
+        return 1;
+    }
+    const long frames = opt.frames > 0 ? opt.frames : (opt.replay ? long(replay.frameCount()) : 300);
+    const std::size_t capacity = opt.replay ? replay.capacity() : opt.particles;
+
+    SplatRenderer renderer(opt.width, opt.height, capacity, opt.threads);
+    int spriteWidth = 0, spriteHeight = 0, channels = 0;
+    if (unsigned char* pixels = stbi_load(opt.sprite, &spriteWidth, &spriteHeight, &channels, 4)) {
+        renderer.setSprite(spriteWidth, spriteHeight, pixels);
+        stbi_image_free(pixels);
+    } else {
+        std::fprintf(stderr, "%s not found, using a gaussian halo\n", opt.sprite);
+    }
+
+    const std::filesystem::path directory = std::filesystem::path(opt.out).parent_path();
+    std::error_code error;
+    if (!directory.empty()) std::filesystem::create_directories(directory, error);
+
+    const unsigned int encoders = opt.encoders ? opt.encoders : std::max(1u, std::thread::hardware_concurrency());
+    FrameWriter writer(opt.width, opt.height, format, encoders);
+
+    // Même simulation que la fenêtre : pas fixe, une image par intervalle de publication
+    SimulationSettings settings;
+    std::unique_ptr<ParticleSystem> live;
+    if (!opt.replay) live = std::make_unique<ParticleSystem>(opt.particles, opt.threads, opt.seed);
+
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), float(opt.width) / float(opt.height), 0.1f, 100.0f);
+    std::printf("supernova_render  %dx%d  threads=%u  encoders=%u  %s\n", opt.width, opt.height,
+                renderer.threadCount(), encoders, opt.replay ? opt.replay : "live simulation");
+
+    double renderMs = 0.0;
+    std::size_t splats = 0, binned = 0;
+    std::vector<char> path(opt.out.size() + 32);
+    const Clock::time_point start = Clock::now();
+    for (long f = 0; f < frames; ++f) {
+        ParticleView frame;
+        float time = 0.0f;
+        if (live) {
+            for (unsigned int s = 0; s < settings.substeps; ++s) live->update(settings.fixedStep);
+            frame = live->view();
+            time = float(f + 1) * settings.fixedStep * float(settings.substeps);
+        } else {
+            const std::size_t index = std::size_t(f) % replay.frameCount();
+            frame = replay.frame(index);
+            time = replay.frameTime(index);
+        }
+
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 15.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        view = glm::rotate(view, glm::radians(time * 10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        const Clock::time_point renderStart = Clock::now();
+        renderer.render(frame, view, projection);
+        renderMs += std::chrono::duration<double, std::milli>(Clock::now() - renderStart).count();
+        splats += renderer.splatCount();
+        binned += renderer.binnedCount();
+
+        std::snprintf(path.data(), path.size(), opt.out.c_str(), int(f));
+        writer.submit(path.data(), [&](auto* image) {
+            if constexpr (std::is_same_v<decltype(image), float*>) {
+                std::copy_n(renderer.pixels(), std::size_t(opt.width) * opt.height * 4, image);
+            } else {
+                renderer.resolve(image);
+            }
+        });
+        SUPERNOVA_PROFILE_FRAME();
+    }
+    const bool written = writer.finish();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("%ld frames in %.2f s (%.2f frames/s), render %.1f ms/frame, %.0f splats and %.0f tile entries per frame\n",
+                frames, seconds, frames / seconds, renderMs / frames, double(splats) / frames, double(binned) / frames);
+    if (Profiler::enabled) Profiler::printSummary(stdout);
+    return written ? 0 : 1;
+}